@@ -1,25 +1,38 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <map>
+#include <utility>
+#include <vector>
 #include "../CachePolicy.h"
+#include "../ShardsTracker.hpp"
 #include "ArcLfuPart.hpp"
 #include "ArcLruPart.hpp"
 
 namespace MyCache
 {
-    template <typename Key, typename Value>
+    /* 两部分各自持锁，幽灵表命中在所属部分的锁内处理，两部分之间的容量转移另外持有ArcCache的锁，整体可以在多线程间共享；
+       Lock为NullLock时两部分都不加锁，适合每个线程独占一个实例 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
     class ArcCache : public CachePolicy<Key, Value>
     {
     public:
         ArcCache(size_t capacity, size_t transformThreshold=2)
             : capacity_(capacity), transformThreshold_(transformThreshold)
         {
-            lruPart_ = std::make_unique<ArcLruPart<Key, Value>>(capacity, transformThreshold);
-            lfuPart_ = std::make_unique<ArcLfuPart<Key, Value>>(capacity, transformThreshold);
+            lruPart_ = std::make_unique<ArcLruPart<Key, Value, Lock>>(capacity, transformThreshold);
+            lfuPart_ = std::make_unique<ArcLfuPart<Key, Value, Lock>>(capacity, transformThreshold);
         }
 
         ~ArcCache() override = default;
 
+        // 挂接未命中率曲线估计器(需在并发访问前调用)，估计的是同样访问序列下LRU在各容量的表现
+        void setMissRatioTracker(std::shared_ptr<ShardsTracker<Key>> tracker)
+        {
+            tracker_ = std::move(tracker);
+        }
+
         void put(Key key, Value value) override
         {
             bool inGhost = checkGhostCaches(key);
@@ -39,6 +52,8 @@ namespace MyCache
 
         bool get(Key key, Value &value) override
         {
+            if (tracker_)
+                tracker_->record(key);
             checkGhostCaches(key);
 
             bool shouldTransform = false;
@@ -60,12 +75,96 @@ namespace MyCache
             return value;
         }
 
+        size_t getCapacity()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return capacity_;
+        }
+
+        /* 在线调整总容量：两部分的容量之和始终是总容量的两倍(幽灵表命中只在两部分之间转移)，
+           新的和按两部分当前所占比例分配，保留ARC已经学到的偏向，幽灵表容量随总容量调整；
+           扩容时预留哈希表的桶，缩容时超出的部分由之后的put每次最多淘汰一批，也可以调用evictExcess主动推进。 */
+        void setCapacity(size_t capacity)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            long long lruOld = static_cast<long long>(lruPart_->getCapacity());
+            long long lfuOld = static_cast<long long>(lfuPart_->getCapacity());
+            long long sumNew = 2LL * static_cast<long long>(capacity);
+            long long lruNew = lruOld + lfuOld > 0 ? std::llround(static_cast<double>(lruOld) * sumNew / (lruOld + lfuOld))
+                                                   : static_cast<long long>(capacity);
+            lruPart_->resize(lruNew - lruOld, capacity);
+            lfuPart_->resize(sumNew - lruNew - lfuOld, capacity);
+            capacity_ = capacity;
+        }
+
+        // 两部分各淘汰最多maxCount个超出容量的节点，返回是否仍超出容量
+        bool evictExcess(size_t maxCount)
+        {
+            bool lruRemaining = lruPart_->evictExcess(maxCount);
+            bool lfuRemaining = lfuPart_->evictExcess(maxCount);
+            return lruRemaining || lfuRemaining;
+        }
+
+        /* 弱一致的分块遍历：先按最近访问顺序(从新到旧)走LRU部分，再按频率从高到低走LFU部分，
+           LFU部分中仍在LRU部分里的key已经返回过，不再重复返回。两部分各自挂一个哨兵游标，
+           每次next只在一个部分的锁内走maxCount个节点；被访问和新写入的节点都落在游标身后，遍历总会结束。
+           遍历期间一直没被访问的key至少返回一次，在游标到达之前被访问的key可能漏掉，
+           遍历期间被LRU部分淘汰、只留在LFU部分的key会再返回一次。Scanner不能比缓存活得久。 */
+        class Scanner
+        {
+        public:
+            explicit Scanner(ArcCache &cache) : cache_(&cache), lruCursor_(cache.lruPart_->openScan()), lfuStarted_(false) {}
+
+            Scanner(Scanner &&other) = default;
+            Scanner &operator=(Scanner &&) = delete;
+
+            ~Scanner()
+            {
+                cache_->lruPart_->closeScan(lruCursor_);
+                cache_->lfuPart_->closeScan(lfuCursor_);
+            }
+
+            // 取下一块，遍历结束时返回false
+            bool next(std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+            {
+                chunk.clear();
+                maxCount = std::max<size_t>(maxCount, 1);
+                if (lruCursor_)
+                {
+                    if (cache_->lruPart_->scan(lruCursor_, chunk, maxCount) || !chunk.empty())
+                        return true;
+                }
+                if (!lfuStarted_)
+                {
+                    cache_->lfuPart_->openScan(lfuCursor_);
+                    lfuStarted_ = true;
+                }
+                while (lfuCursor_.node)
+                {
+                    cache_->lfuPart_->scan(lfuCursor_, chunk, maxCount);
+                    cache_->lruPart_->eraseCached(chunk);
+                    if (!chunk.empty())
+                        return true;
+                }
+                return false;
+            }
+
+        private:
+            ArcCache *cache_;
+            typename ArcLruPart<Key, Value, Lock>::NodePtr lruCursor_;
+            typename ArcLfuPart<Key, Value, Lock>::ScanCursor lfuCursor_;
+            bool lfuStarted_;
+        };
+
+        Scanner scan() { return Scanner(*this); }
+
     private:
         bool checkGhostCaches(Key key)
         {
             bool inGhost = false;
             if (lruPart_->checkGhost(key))
             {
+                std::lock_guard<Lock> lock(mutex_);
                 if (lfuPart_->decreaseCapacity())
                 {
                     lruPart_->increaseCapacity();
@@ -74,6 +173,7 @@ namespace MyCache
             }
             else if (lfuPart_->checkGhost(key))
             {
+                std::lock_guard<Lock> lock(mutex_);
                 if (lruPart_->decreaseCapacity())
                 {
                     lfuPart_->increaseCapacity();
@@ -83,10 +183,12 @@ namespace MyCache
             return inGhost;
         }
 
-        std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
-        std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
+        std::unique_ptr<ArcLruPart<Key, Value, Lock>> lruPart_;
+        std::unique_ptr<ArcLfuPart<Key, Value, Lock>> lfuPart_;
 
         size_t capacity_;           // 总容量
+        Lock mutex_;                // 保护总容量和两部分之间的容量转移，先于两部分的锁获取
         size_t transformThreshold_; // 转换阈值
+        std::shared_ptr<ShardsTracker<Key>> tracker_; // 未命中率曲线估计器，可为空
     };
 } // namespace MyCache
@@ -1,19 +1,26 @@
 #pragma once
 
+#include "../NodeLayout.h"
+#include <memory>
+
 namespace MyCache
 {
     template <typename Key, typename Value>
     class ArcCacheNode
     {
     private:
-        Key key_;
-        Value value_;
-        size_t accessCount_; // 访问次数
+        // 热字段：链表指针和访问次数放在最前面
         std::weak_ptr<ArcCacheNode> pre_; // 前驱节点
         std::shared_ptr<ArcCacheNode> next_; // 后继节点
+        size_t accessCount_; // 访问次数
+        // 冷字段
+        Key key_;
+        Value value_;
+
+        static_assert(fitsSharedNodeLine(sizeof(pre_) + sizeof(next_) + sizeof(accessCount_)), "ARC节点热字段超出一个缓存行");
     public:
-        ArcCacheNode():accessCount_(1), next_(nullptr) {}
-        ArcCacheNode(Key key, Value value) : key_(key), value_(value), accessCount_(1), next_(nullptr) {}
+        ArcCacheNode() : next_(nullptr), accessCount_(1) {}
+        ArcCacheNode(Key key, Value value) : next_(nullptr), accessCount_(1), key_(key), value_(value) {}
         // Getters
         Key getKey() const { return key_; }
         Value getValue() const { return value_; }
@@ -22,9 +29,9 @@ namespace MyCache
         void setKey(Key key) { key_ = key; }
         void setValue(Value value) { value_ = value; }
         void incrementAccessCount() { accessCount_++; }
-        template<typename K,typename V>
+        template<typename K,typename V,typename L>
         friend class ArcLruPart; // 允许ArcCache访问私有成员
-        template<typename K,typename V>
+        template<typename K,typename V,typename L>
         friend class ArcLfuPart; // 允许ArcCache访问私有成员
     };
 }
\ No newline at end of file
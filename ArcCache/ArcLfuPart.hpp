@@ -2,11 +2,15 @@
 #include <mutex>
 #include <unordered_map>
 #include <list>
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "ArcCacheNode.hpp"
+#include "../CacheLock.h"
 
 namespace MyCache
 {
-    template <typename Key, typename Value>
+    template <typename Key, typename Value, typename Lock = std::mutex>
 class ArcLfuPart
 {
 public:
@@ -25,10 +29,10 @@ public:
 
     bool put(Key key, Value value)
     {
+        std::lock_guard<Lock> lock(mutex_);
         if (capacity_ == 0)
             return false;
 
-        std::lock_guard<std::mutex> lock(mutex_);
         auto it = mainCache_.find(key);
         if (it != mainCache_.end())
         {
@@ -39,7 +43,7 @@ public:
 
     bool get(Key key, Value &value)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<Lock> lock(mutex_);
         auto it = mainCache_.find(key);
         if (it != mainCache_.end())
         {
@@ -52,6 +56,7 @@ public:
 
     bool checkGhost(Key key)
     {
+        std::lock_guard<Lock> lock(mutex_);
         auto it = ghostCache_.find(key);
         if (it != ghostCache_.end())
         {
@@ -62,10 +67,104 @@ public:
         return false;
     }
 
-    void increaseCapacity() { ++capacity_; }
+    /* 遍历游标：频率列表里访问次数为0的哨兵节点，按频率从高到低、同一频率内从后往前走，
+       被访问的节点移到更高频率列表的末尾，新节点进入频率1列表的末尾，都落在游标身后。 */
+    struct ScanCursor
+    {
+        NodePtr node; // 为空表示遍历结束
+        size_t freq = 0;
+        NodeItr pos;
+    };
+
+    void openScan(ScanCursor &cursor)
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        if (freqMap_.empty())
+            return;
+        cursor.node = makeCacheLineShared<NodeType>();
+        cursor.node->accessCount_ = 0;
+        cursor.freq = freqMap_.rbegin()->first;
+        auto &list = freqMap_.rbegin()->second;
+        cursor.pos = list.insert(list.end(), cursor.node);
+    }
+
+    // 最多走maxCount个节点，追加到chunk；走到头时关闭游标并返回false
+    bool scan(ScanCursor &cursor, std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+    {
+        if (!cursor.node)
+            return false;
+        std::lock_guard<Lock> lock(mutex_);
+        auto listIt = freqMap_.find(cursor.freq);
+        NodeItr it = cursor.pos; // 最后走过的位置，游标之后挪到它前面
+        for (size_t count = 0; count < maxCount; ++count)
+        {
+            if (it == listIt->second.begin())
+            {
+                if (listIt == freqMap_.begin())
+                {
+                    eraseCursor(cursor);
+                    return false;
+                }
+                --listIt;
+                it = listIt->second.end();
+                continue;
+            }
+            --it;
+            if ((*it)->accessCount_ != 0) // 跳过其他遍历的游标
+                chunk.emplace_back((*it)->getKey(), (*it)->getValue());
+        }
+        auto &oldList = freqMap_[cursor.freq];
+        listIt->second.splice(it, oldList, cursor.pos);
+        if (oldList.empty())
+            freqMap_.erase(cursor.freq);
+        cursor.freq = listIt->first;
+        return true;
+    }
+
+    void closeScan(ScanCursor &cursor)
+    {
+        if (!cursor.node)
+            return;
+        std::lock_guard<Lock> lock(mutex_);
+        eraseCursor(cursor);
+    }
+
+    size_t getCapacity()
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        return capacity_;
+    }
+
+    // 本部分容量增加delta(最低为0)，幽灵表容量等于总容量；按增量调整，不会覆盖期间幽灵表命中转移的容量
+    void resize(long long delta, size_t ghostCapacity)
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        capacity_ = static_cast<size_t>(std::max(0LL, static_cast<long long>(capacity_) + delta));
+        ghostCapacity_ = ghostCapacity;
+        if (capacity_ > mainCache_.bucket_count() * mainCache_.max_load_factor())
+            mainCache_.reserve(capacity_);
+    }
+
+    // 淘汰最多maxCount个超出容量的节点(含幽灵表)，返回是否仍超出容量
+    bool evictExcess(size_t maxCount)
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        for (size_t n = 0; n < maxCount && mainCache_.size() > capacity_; ++n)
+            evictLeastFrequent();
+        for (size_t n = 0; n < maxCount && ghostCache_.size() > ghostCapacity_; ++n)
+            removeOldestGhost();
+        return mainCache_.size() > capacity_ || ghostCache_.size() > ghostCapacity_;
+    }
+
+    void increaseCapacity()
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        ++capacity_;
+    }
 
     bool decreaseCapacity()
     {
+        std::lock_guard<Lock> lock(mutex_);
         if (capacity_ <= 0)
             return false;
         if (mainCache_.size() == capacity_)
@@ -79,8 +178,8 @@ public:
 private:
     void initializeLists()
     {
-        ghostHead_ = std::make_shared<NodeType>();
-        ghostTail_ = std::make_shared<NodeType>();
+        ghostHead_ = makeCacheLineShared<NodeType>();
+        ghostTail_ = makeCacheLineShared<NodeType>();
         ghostHead_->next_ = ghostTail_;
         ghostTail_->pre_ = ghostHead_;
     }
@@ -94,12 +193,11 @@ private:
 
     bool addNewNode(const Key &key, const Value &value)
     {
-        if (mainCache_.size() >= capacity_)
-        {
+        // 缩容后超出的部分每次顺带多淘汰几个
+        for (int n = 0; n < kShrinkBatch && mainCache_.size() >= capacity_; ++n)
             evictLeastFrequent();
-        }
 
-        NodePtr newNode = std::make_shared<NodeType>(key, value);
+        NodePtr newNode = makeCacheLineShared<NodeType>(key, value);
         mainCache_[key] = newNode;
         // 将新节点添加到频率为1的列表中
         if (freqMap_.find(1) == freqMap_.end())
@@ -143,19 +241,29 @@ private:
         if (freqMap_.empty())
             return;
 
-        // 获取最小频率的列表
-        auto &minFreqList = freqMap_[minFreq_];
-        if (minFreqList.empty())
+        // 获取最小频率的列表，跳过遍历游标；只剩游标的列表往后找
+        auto isNode = [](const NodePtr &node)
+        { return node->accessCount_ != 0; };
+        auto listIt = freqMap_.lower_bound(minFreq_);
+        NodeItr nodeIt;
+        for (; listIt != freqMap_.end(); ++listIt)
+        {
+            nodeIt = std::find_if(listIt->second.begin(), listIt->second.end(), isNode);
+            if (nodeIt != listIt->second.end())
+                break;
+        }
+        if (listIt == freqMap_.end())
             return;
+        auto &minFreqList = listIt->second;
 
         // 移除最少使用的节点
-        NodePtr leastNode = minFreqList.front();
-        minFreqList.pop_front();
+        NodePtr leastNode = *nodeIt;
+        minFreqList.erase(nodeIt);
 
         // 如果该频率的列表为空，则删除该频率项
         if (minFreqList.empty())
         {
-            freqMap_.erase(minFreq_);
+            freqMap_.erase(listIt);
             // 更新最小频率
             if (!freqMap_.empty())
             {
@@ -174,6 +282,15 @@ private:
         mainCache_.erase(leastNode->getKey());
     }
 
+    void eraseCursor(ScanCursor &cursor)
+    {
+        auto listIt = freqMap_.find(cursor.freq);
+        listIt->second.erase(cursor.pos);
+        if (listIt->second.empty())
+            freqMap_.erase(listIt);
+        cursor.node.reset();
+    }
+
     void removeFromGhost(NodePtr node)
     {
         if (!node->pre_.expired() && node->next_)
@@ -212,7 +329,9 @@ private:
     size_t ghostCapacity_;
     size_t transformThreshold_;
     size_t minFreq_;
-    std::mutex mutex_;
+    Lock mutex_;
+
+    static const int kShrinkBatch = 64; // 缩容后每次写入最多淘汰的节点数
 
     NodeMap mainCache_;
     NodeMap ghostCache_;
@@ -1,11 +1,15 @@
 #pragma once
+#include <algorithm>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "ArcCacheNode.hpp"
+#include "../CacheLock.h"
 
 namespace MyCache
 {
-    template <typename Key, typename Value>
+    template <typename Key, typename Value, typename Lock = std::mutex>
     class ArcLruPart
     {
     public:
@@ -20,11 +24,11 @@ namespace MyCache
 
         bool put(Key key, Value value)
         {
+            std::lock_guard<Lock> lock(mutex_);
             if (capacity_ <= 0)
             {
                 return false;
             }
-            std::lock_guard<std::mutex> lock(mutex_);
             auto it = mainCache_.find(key);
             if (it != mainCache_.end())
             {
@@ -37,7 +41,7 @@ namespace MyCache
 
         bool get(Key key, Value &value, bool &shouldTransform)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<Lock> lock(mutex_);
             auto it = mainCache_.find(key);
             if (it != mainCache_.end())
             {
@@ -50,7 +54,7 @@ namespace MyCache
         }
         bool checkGhost(Key key)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<Lock> lock(mutex_);
             auto it = ghostCache_.find(key);
             if (it != ghostCache_.end())
             {
@@ -61,10 +65,100 @@ namespace MyCache
             return false;
         }
 
-        void increaseCapacity() { ++capacity_; }
+        /* 遍历游标是挂在主链表里、访问次数为0的哨兵节点，从最近访问往最久未访问走，
+           被访问和新写入的节点移到表头，落在游标身后(见ArcCache::Scanner)。 */
+        NodePtr openScan()
+        {
+            NodePtr cursor = makeCacheLineShared<NodeType>();
+            cursor->accessCount_ = 0;
+            std::lock_guard<Lock> lock(mutex_);
+            linkAfter(mainHead_, cursor);
+            return cursor;
+        }
+
+        // 最多走maxCount个节点，追加到chunk；走到头时关闭游标并返回false
+        bool scan(NodePtr &cursor, std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+        {
+            if (!cursor)
+                return false;
+            std::lock_guard<Lock> lock(mutex_);
+            NodePtr last = cursor;
+            NodePtr node = cursor->next_;
+            for (size_t count = 0; node != mainTail_ && count < maxCount; ++count)
+            {
+                if (node->accessCount_ != 0) // 跳过其他遍历的游标
+                    chunk.emplace_back(node->getKey(), node->getValue());
+                last = node;
+                node = node->next_;
+            }
+            removeFromMain(cursor);
+            if (node == mainTail_)
+            {
+                cursor.reset();
+                return false;
+            }
+            linkAfter(last, cursor);
+            return true;
+        }
+
+        void closeScan(NodePtr &cursor)
+        {
+            if (!cursor)
+                return;
+            std::lock_guard<Lock> lock(mutex_);
+            removeFromMain(cursor);
+            cursor.reset();
+        }
+
+        // 删掉entries中仍在主链表里的key
+        void eraseCached(std::vector<std::pair<Key, Value>> &entries)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            size_t kept = 0;
+            for (auto &entry : entries)
+            {
+                if (mainCache_.find(entry.first) == mainCache_.end())
+                    entries[kept++] = std::move(entry);
+            }
+            entries.resize(kept);
+        }
+
+        size_t getCapacity()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return capacity_;
+        }
+
+        // 本部分容量增加delta(最低为0)，幽灵表容量等于总容量；按增量调整，不会覆盖期间幽灵表命中转移的容量
+        void resize(long long delta, size_t ghostCapacity)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            capacity_ = static_cast<size_t>(std::max(0LL, static_cast<long long>(capacity_) + delta));
+            ghostCapacity_ = ghostCapacity;
+            if (capacity_ > mainCache_.bucket_count() * mainCache_.max_load_factor())
+                mainCache_.reserve(capacity_);
+        }
+
+        // 淘汰最多maxCount个超出容量的节点(含幽灵表)，返回是否仍超出容量
+        bool evictExcess(size_t maxCount)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            for (size_t n = 0; n < maxCount && mainCache_.size() > capacity_; ++n)
+                evictLeastRecent();
+            for (size_t n = 0; n < maxCount && ghostCache_.size() > ghostCapacity_; ++n)
+                removeOldestFromGhost();
+            return mainCache_.size() > capacity_ || ghostCache_.size() > ghostCapacity_;
+        }
+
+        void increaseCapacity()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            ++capacity_;
+        }
 
         bool decreaseCapacity()
         {
+            std::lock_guard<Lock> lock(mutex_);
             if (capacity_ <= 0)
                 return false;
             if (mainCache_.size() >= capacity_)
@@ -85,17 +179,19 @@ namespace MyCache
         NodePtr ghostHead_; // 淘汰链表头
         NodePtr ghostTail_; // 淘汰表尾
 
-        std::mutex mutex_;
+        Lock mutex_;
+
+        static const int kShrinkBatch = 64; // 缩容后每次写入最多淘汰的节点数
 
         NodeMap mainCache_;  // key -> mainNodePtr 映射
         NodeMap ghostCache_; // key -> ghostNodePtr 映射
 
         void initList()
         {
-            mainHead_ = std::make_shared<NodeType>();
-            mainTail_ = std::make_shared<NodeType>();
-            ghostHead_ = std::make_shared<NodeType>();
-            ghostTail_ = std::make_shared<NodeType>();
+            mainHead_ = makeCacheLineShared<NodeType>();
+            mainTail_ = makeCacheLineShared<NodeType>();
+            ghostHead_ = makeCacheLineShared<NodeType>();
+            ghostTail_ = makeCacheLineShared<NodeType>();
 
             mainHead_->next_ = mainTail_;
             mainTail_->pre_ = mainHead_;
@@ -125,17 +221,23 @@ namespace MyCache
 
         bool addNeWNode(Key key, Value value)
         {
-            if (mainCache_.size() >= capacity_)
-            {
-                // 如果主链表已满，淘汰最少使用的节点
+            // 如果主链表已满，淘汰最少使用的节点；缩容后超出的部分每次顺带多淘汰几个
+            for (int n = 0; n < kShrinkBatch && mainCache_.size() >= capacity_; ++n)
                 evictLeastRecent();
-            }
-            NodePtr newNode = std::make_shared<NodeType>(key, value);
+            NodePtr newNode = makeCacheLineShared<NodeType>(key, value);
             mainCache_[key] = newNode;
             addToFront(newNode);
             return true;
         }
 
+        void linkAfter(const NodePtr &pos, const NodePtr &node)
+        {
+            pos->next_->pre_ = node;
+            node->next_ = pos->next_;
+            pos->next_ = node;
+            node->pre_ = pos;
+        }
+
         void addToFront(NodePtr node)
         {
             // 将节点移动到主链表头部
@@ -149,6 +251,8 @@ namespace MyCache
         {
             // 淘汰最少使用的节点
             NodePtr leastRecent = mainTail_->pre_.lock();
+            while (leastRecent && leastRecent != mainHead_ && leastRecent->accessCount_ == 0) // 跳过遍历游标
+                leastRecent = leastRecent->pre_.lock();
             if (leastRecent == mainHead_ || !leastRecent)
                 return; // 主链表为空
 
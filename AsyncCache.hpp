@@ -0,0 +1,153 @@
+#pragma once
+
+// 需要C++20协程，只有以C++20编译的目标才包含本文件
+#include "CachePolicy.h"
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MyCache
+{
+    /* 协程友好的异步缓存：co_await cache.getAsync(key, loader)得到std::optional<Value>。
+       - 命中在await_ready中同步完成，不挂起，也不分配任何协程帧；
+       - 未命中时同一个key同时只有一次加载，后来的等待者挂到同一次加载上；
+       - 加载完成后先写入底层缓存，再把所有等待者交给调用方提供的执行器恢复。
+       loader以回调方式完成：loader(key, done)，done(std::nullopt)表示加载失败，done可以在任意线程调用。
+       AsyncCache必须比所有未完成的加载活得久。 */
+    template <typename Key, typename Value, typename Cache = CachePolicy<Key, Value>>
+    class AsyncCache
+    {
+    public:
+        using Completion = std::function<void(std::optional<Value>)>;
+        using Loader = std::function<void(const Key &key, Completion done)>;
+        using Executor = std::function<void(std::coroutine_handle<>)>;
+
+        class GetAwaiter;
+
+        // 默认在完成加载的线程上直接恢复
+        explicit AsyncCache(Cache &cache, Executor executor = [](std::coroutine_handle<> handle)
+                            { handle.resume(); })
+            : cache_(cache), executor_(std::move(executor)) {}
+
+        AsyncCache(const AsyncCache &) = delete;
+        AsyncCache &operator=(const AsyncCache &) = delete;
+
+        GetAwaiter getAsync(Key key, Loader loader)
+        {
+            return GetAwaiter(*this, std::move(key), std::move(loader));
+        }
+
+        // 同步写入；正在进行的同key加载完成后不再覆盖这次写入
+        void put(const Key &key, const Value &value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = inflight_.find(key);
+            if (it != inflight_.end())
+                it->second.stale = true;
+            cache_.put(key, value);
+        }
+
+        size_t inflightCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return inflight_.size();
+        }
+
+        class GetAwaiter
+        {
+        public:
+            GetAwaiter(AsyncCache &owner, Key key, Loader loader)
+                : owner_(owner), key_(std::move(key)), loader_(std::move(loader)) {}
+
+            bool await_ready()
+            {
+                Value value;
+                if (!owner_.cache_.get(key_, value))
+                    return false;
+                result_ = std::move(value);
+                return true;
+            }
+
+            // 返回false表示无需挂起(加锁后发现已被别的加载填充)
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                handle_ = handle;
+                return owner_.join(this);
+            }
+
+            std::optional<Value> await_resume() { return std::move(result_); }
+
+        private:
+            friend class AsyncCache;
+
+            AsyncCache &owner_;
+            Key key_;
+            Loader loader_;
+            std::optional<Value> result_;
+            std::coroutine_handle<> handle_;
+        };
+
+    private:
+        struct Load
+        {
+            std::vector<GetAwaiter *> waiters;
+            bool stale = false; // 加载期间被put覆盖过
+        };
+
+        bool join(GetAwaiter *waiter)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // 加载完成时先写缓存再摘除inflight_，所以这里再查一次缓存不会漏掉结果
+                Value value;
+                if (cache_.get(waiter->key_, value))
+                {
+                    waiter->result_ = std::move(value);
+                    return false;
+                }
+                auto it = inflight_.find(waiter->key_);
+                if (it != inflight_.end())
+                {
+                    it->second.waiters.push_back(waiter);
+                    return true;
+                }
+                inflight_[waiter->key_].waiters.push_back(waiter);
+            }
+            // 发起加载后不能再访问waiter，完成回调可能已经恢复并销毁了它
+            Key key = waiter->key_;
+            Loader loader = std::move(waiter->loader_);
+            loader(key, [this, key](std::optional<Value> value)
+                   { complete(key, std::move(value)); });
+            return true;
+        }
+
+        void complete(const Key &key, std::optional<Value> value)
+        {
+            std::vector<GetAwaiter *> waiters;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = inflight_.find(key);
+                if (it == inflight_.end())
+                    return;
+                if (value && !it->second.stale)
+                    cache_.put(key, *value);
+                waiters.swap(it->second.waiters);
+                inflight_.erase(it);
+            }
+            for (GetAwaiter *waiter : waiters)
+            {
+                waiter->result_ = value;
+                executor_(waiter->handle_);
+            }
+        }
+
+        Cache &cache_;
+        Executor executor_;
+        std::mutex mutex_; // 保护inflight_
+        std::unordered_map<Key, Load> inflight_;
+    };
+}
@@ -0,0 +1,11 @@
+#pragma once
+namespace MyCache
+{
+    // 空锁：单线程使用时代替std::mutex，lock/unlock内联后不产生任何指令
+    struct NullLock
+    {
+        void lock() {}
+        void unlock() {}
+        bool try_lock() { return true; }
+    };
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <utility>
+
 namespace MyCache
 {
     template <typename Key, typename Value>
@@ -16,4 +18,51 @@ namespace MyCache
         // 只返回值
         virtual Value get(Key key) = 0;
     };
+
+    /* 静态接口(CRTP)：派生类实现putImpl/getImpl，模板化的调用方通过StaticCachePolicy<Derived, ...>&
+       调用时没有虚函数分派，哈希和比较可以内联进调用循环。 */
+    template <typename Derived, typename Key, typename Value>
+    class StaticCachePolicy
+    {
+    public:
+        // 放入元素
+        void put(const Key &key, const Value &value) { derived().putImpl(key, value); }
+
+        // 通过引用返回val值，bool表示寻找情况
+        bool get(const Key &key, Value &value) { return derived().getImpl(key, value); }
+
+        // 只返回值
+        Value get(const Key &key)
+        {
+            Value value{};
+            derived().getImpl(key, value);
+            return value;
+        }
+
+    protected:
+        ~StaticCachePolicy() = default;
+
+    private:
+        Derived &derived() { return static_cast<Derived &>(*this); }
+    };
+
+    // 把静态接口的缓存包装成虚接口，便于放进CachePolicy*数组或交给模拟器
+    template <typename Cache, typename Key, typename Value>
+    class VirtualCacheAdapter : public CachePolicy<Key, Value>
+    {
+    public:
+        template <typename... Args>
+        explicit VirtualCacheAdapter(Args &&...args) : cache_(std::forward<Args>(args)...) {}
+
+        void put(Key key, Value value) override { cache_.put(key, value); }
+
+        bool get(Key key, Value &value) override { return cache_.get(key, value); }
+
+        Value get(Key key) override { return cache_.get(key); }
+
+        Cache &cache() { return cache_; }
+
+    private:
+        Cache cache_;
+    };
 }
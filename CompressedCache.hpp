@@ -0,0 +1,240 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "ValueCodec.hpp"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace MyCache
+{
+    /* 透明压缩的value适配器：Policy<Key, Blob, Lock>负责淘汰，适配器只决定每个条目以什么形式存放。
+       - 热集：最近访问过的hotCapacity个key保持解压状态，读取只是一次拷贝；
+       - 条目被挤出热集(正在走向淘汰端)时才压缩并释放原文，冷条目只占压缩后的空间；
+       - 冷条目被读到时解压并重新进入热集，压缩结果保留，再次变冷时直接丢掉原文，不用重新压缩。
+       只在写入后很快被读的条目从不压缩；压缩不划算(结果不比原文小)的条目一直保存原文。
+       热集是适配器自己的LRU，近似底层策略中靠近头部的条目(LFU/ARC下也按最近访问判断)。
+       底层策略按条目数计容量，省下的内存可以换成更大的容量，storedBytes()返回当前实际占用的value字节数。
+       压缩和解压都在适配器的锁之外进行，锁内只交换指针。
+       put在适配器的锁内写入底层策略并给条目编版本号，与写入顺序一致；并发的get拿到被替换的旧条目时，
+       热集只保留版本更新的那个，被替换的条目清掉hot标记，因此仍在缓存中的条目hot为真当且仅当它在热集里。 */
+    template <typename Key, template <typename, typename, typename> class Policy, typename Lock = std::mutex>
+    class CompressedCache : public CachePolicy<Key, std::string>
+    {
+    public:
+        // policyArgs转发给底层策略的构造函数，如LruCache的capacity
+        template <typename... Args>
+        CompressedCache(size_t hotCapacity, ValueCodec::Kind codec, Args &&...policyArgs)
+            : hotCapacity_(hotCapacity), codec_(ValueCodec::available(codec) ? codec : ValueCodec::Kind::Builtin),
+              stats_(std::make_shared<Stats>()), cache_(std::forward<Args>(policyArgs)...)
+        {
+        }
+
+        void put(Key key, std::string value) override
+        {
+            auto blob = std::make_shared<Blob>(stats_);
+            blob->rawSize = value.size();
+            blob->setRaw(std::make_shared<const std::string>(std::move(value)));
+            BlobPtr cold;
+            {
+                std::lock_guard<Lock> lock(mutex_);
+                blob->version = ++version_;
+                cache_.put(key, blob);
+                cold = touchLocked(key, blob);
+            }
+            if (cold)
+                demote(cold);
+        }
+
+        bool get(Key key, std::string &value) override
+        {
+            BlobPtr blob;
+            if (!cache_.get(key, blob))
+                return false;
+            std::shared_ptr<const std::string> raw, compressed;
+            {
+                std::lock_guard<Lock> lock(mutex_);
+                raw = blob->raw;
+                compressed = blob->compressed;
+            }
+            if (!raw)
+            {
+                // 冷条目：解压后放回原文
+                auto decoded = std::make_shared<std::string>();
+                if (!ValueCodec::decompress(codec_, *compressed, blob->rawSize, *decoded))
+                    return false;
+                raw = decoded;
+                stats_->decompressions.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<Lock> lock(mutex_);
+                if (!blob->raw)
+                    blob->setRaw(raw);
+            }
+            value = *raw;
+            touch(key, blob);
+            return true;
+        }
+
+        std::string get(Key key) override
+        {
+            std::string value;
+            get(key, value);
+            return value;
+        }
+
+        // 仍在缓存中(含热集)的条目实际占用的value字节数：原文 + 压缩结果
+        size_t storedBytes() const { return stats_->storedBytes.load(std::memory_order_relaxed); }
+        // 写入过的原文字节数减去被淘汰的，即不压缩时应占用的字节数
+        size_t rawBytes() const { return stats_->rawBytes.load(std::memory_order_relaxed); }
+        uint64_t compressions() const { return stats_->compressions.load(std::memory_order_relaxed); }
+        uint64_t decompressions() const { return stats_->decompressions.load(std::memory_order_relaxed); }
+        ValueCodec::Kind codec() const { return codec_; }
+
+    private:
+        // 各条目共享的计数，条目被底层策略淘汰析构时也要更新，因此单独分配
+        struct Stats
+        {
+            std::atomic<size_t> storedBytes{0};
+            std::atomic<size_t> rawBytes{0};
+            std::atomic<uint64_t> compressions{0};
+            std::atomic<uint64_t> decompressions{0};
+        };
+
+        // raw和compressed至少有一个非空，只在适配器的锁内修改
+        struct Blob
+        {
+            explicit Blob(std::shared_ptr<Stats> stats) : rawSize(0), version(0), hot(false), incompressible(false), stats(std::move(stats)) {}
+
+            ~Blob()
+            {
+                stats->storedBytes.fetch_sub(bytes(raw) + bytes(compressed), std::memory_order_relaxed);
+                stats->rawBytes.fetch_sub(rawSize, std::memory_order_relaxed);
+            }
+
+            void setRaw(std::shared_ptr<const std::string> value)
+            {
+                if (!raw && !compressed)
+                    stats->rawBytes.fetch_add(rawSize, std::memory_order_relaxed);
+                stats->storedBytes.fetch_add(bytes(value), std::memory_order_relaxed);
+                raw = std::move(value);
+            }
+
+            void dropRaw()
+            {
+                stats->storedBytes.fetch_sub(bytes(raw), std::memory_order_relaxed);
+                raw.reset();
+            }
+
+            void setCompressed(std::shared_ptr<const std::string> value)
+            {
+                stats->storedBytes.fetch_add(bytes(value), std::memory_order_relaxed);
+                compressed = std::move(value);
+            }
+
+            static size_t bytes(const std::shared_ptr<const std::string> &value) { return value ? value->size() : 0; }
+
+            size_t rawSize;
+            uint64_t version; // put的顺序，越大越新
+            bool hot;         // 是否在热集中
+            bool incompressible;
+            std::shared_ptr<const std::string> raw;
+            std::shared_ptr<const std::string> compressed;
+            std::shared_ptr<Stats> stats;
+        };
+
+        using BlobPtr = std::shared_ptr<Blob>;
+        using HotList = std::list<std::pair<Key, std::weak_ptr<Blob>>>;
+
+        // 把key移到热集头部，挤出热集的条目在锁外压缩
+        void touch(const Key &key, const BlobPtr &blob)
+        {
+            BlobPtr cold;
+            {
+                std::lock_guard<Lock> lock(mutex_);
+                cold = touchLocked(key, blob);
+            }
+            if (cold)
+                demote(cold);
+        }
+
+        // 调用方持有mutex_，返回需要在锁外压缩的条目
+        BlobPtr touchLocked(const Key &key, const BlobPtr &blob)
+        {
+            auto it = hotMap_.find(key);
+            if (it != hotMap_.end())
+            {
+                BlobPtr current = it->second->second.lock();
+                if (current && current != blob)
+                {
+                    // get拿到的是已被put替换的旧条目，热集里保留新的
+                    if (current->version > blob->version)
+                        return nullptr;
+                    current->hot = false;
+                }
+                it->second->second = blob;
+                hotList_.splice(hotList_.begin(), hotList_, it->second);
+            }
+            else
+            {
+                hotList_.emplace_front(key, blob);
+                hotMap_.emplace(key, hotList_.begin());
+            }
+            blob->hot = true;
+            if (hotList_.size() <= hotCapacity_)
+                return nullptr;
+            BlobPtr cold = hotList_.back().second.lock(); // 已被底层策略淘汰的条目不用处理
+            hotMap_.erase(hotList_.back().first);
+            hotList_.pop_back();
+            if (!cold)
+                return nullptr;
+            cold->hot = false;
+            if (cold->incompressible)
+                return nullptr;
+            if (cold->compressed)
+            {
+                cold->dropRaw();
+                return nullptr;
+            }
+            return cold;
+        }
+
+        void demote(const BlobPtr &blob)
+        {
+            std::shared_ptr<const std::string> raw;
+            {
+                std::lock_guard<Lock> lock(mutex_);
+                raw = blob->raw;
+            }
+            if (!raw)
+                return;
+            auto compressed = std::make_shared<const std::string>(ValueCodec::compress(codec_, *raw));
+            stats_->compressions.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<Lock> lock(mutex_);
+            if (blob->compressed || blob->raw != raw)
+                return;
+            if (compressed->empty() && !raw->empty())
+                return; // 压缩失败，保留原文
+            if (compressed->size() >= raw->size())
+            {
+                blob->incompressible = true;
+                return;
+            }
+            blob->setCompressed(compressed);
+            // 压缩期间又被读到、回到热集的条目保留原文
+            if (!blob->hot)
+                blob->dropRaw();
+        }
+
+        size_t hotCapacity_;
+        ValueCodec::Kind codec_;
+        std::shared_ptr<Stats> stats_;
+        Policy<Key, BlobPtr, Lock> cache_;
+        Lock mutex_;           // 保护热集、版本号和各条目的raw/compressed/hot
+        uint64_t version_ = 0; // 最近一次put的版本号
+        HotList hotList_;
+        std::unordered_map<Key, typename HotList::iterator> hotMap_;
+    };
+}
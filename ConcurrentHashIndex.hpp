@@ -0,0 +1,185 @@
+#pragma once
+
+#include "EpochReclaimer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace MyCache
+{
+    /* 并发开放寻址哈希索引：key -> Node*，Node需要有key成员。
+       - 读(find)无锁且从不阻塞，调用方需在reclaimer().pin()的作用域内使用返回的节点；
+       - 写(insert/replace/erase)需由调用方串行化，删除留下墓碑，墓碑过多或装载率过高时整表重建，
+         旧表通过epoch回收，正在读旧表的读者不受影响；
+       - 索引不拥有节点，erase/replace返回被摘除的节点，由调用方retire。
+       接口与HashIndex一致，也可以作为CacheEngine的索引策略。 */
+    template <typename Key, typename Node>
+    class ConcurrentHashIndex
+    {
+    public:
+        explicit ConcurrentHashIndex(size_t capacity = 0) : live_(0), used_(0)
+        {
+            table_.store(new Table(tableSizeFor(capacity)), std::memory_order_relaxed);
+        }
+
+        ~ConcurrentHashIndex()
+        {
+            delete table_.load(std::memory_order_relaxed);
+        }
+
+        ConcurrentHashIndex(const ConcurrentHashIndex &) = delete;
+        ConcurrentHashIndex &operator=(const ConcurrentHashIndex &) = delete;
+
+        EpochReclaimer &reclaimer() { return reclaimer_; }
+
+        Node *find(const Key &key) const
+        {
+            const Table *table = table_.load(std::memory_order_acquire);
+            uint64_t hash = hashOf(key);
+            size_t index = hash & table->mask;
+            for (size_t probe = 0; probe <= table->mask; ++probe, index = (index + 1) & table->mask)
+            {
+                const Slot &slot = table->slots[index];
+                Node *node = slot.node.load(std::memory_order_acquire);
+                if (!node)
+                    return nullptr;
+                // 哈希只用于过滤，槽位可能刚被复用，最终以节点中的key为准
+                if (node != tombstone() && slot.hash.load(std::memory_order_relaxed) == hash && node->key == key)
+                    return node;
+            }
+            return nullptr;
+        }
+
+        // key必须不存在
+        void insert(const Key &key, Node *node)
+        {
+            Table *table = table_.load(std::memory_order_relaxed);
+            if ((used_ + 1) * 4 > (table->mask + 1) * 3)
+                table = rebuild(tableSizeFor(live_ + 1));
+            uint64_t hash = hashOf(key);
+            size_t index = hash & table->mask;
+            while (true)
+            {
+                Slot &slot = table->slots[index];
+                Node *current = slot.node.load(std::memory_order_relaxed);
+                if (!current || current == tombstone())
+                {
+                    if (!current)
+                        used_++;
+                    slot.hash.store(hash, std::memory_order_relaxed);
+                    slot.node.store(node, std::memory_order_release);
+                    live_.store(live_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+                index = (index + 1) & table->mask;
+            }
+        }
+
+        // 原地替换key对应的节点，返回旧节点，key不存在时返回nullptr
+        Node *replace(const Key &key, Node *node)
+        {
+            Slot *slot = findSlot(key);
+            if (!slot)
+                return nullptr;
+            Node *old = slot->node.load(std::memory_order_relaxed);
+            slot->node.store(node, std::memory_order_release);
+            return old;
+        }
+
+        // 返回被摘除的节点，key不存在时返回nullptr
+        Node *erase(const Key &key)
+        {
+            Slot *slot = findSlot(key);
+            if (!slot)
+                return nullptr;
+            Node *old = slot->node.load(std::memory_order_relaxed);
+            slot->node.store(tombstone(), std::memory_order_release);
+            live_.store(live_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            return old;
+        }
+
+        size_t size() const { return live_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> hash{0};
+            std::atomic<Node *> node{nullptr}; // 空、墓碑或节点
+        };
+
+        struct Table
+        {
+            explicit Table(size_t size) : mask(size - 1), slots(new Slot[size]) {}
+
+            size_t mask;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        static Node *tombstone() { return reinterpret_cast<Node *>(static_cast<uintptr_t>(1)); }
+
+        static uint64_t hashOf(const Key &key)
+        {
+            uint64_t hash = std::hash<Key>()(key);
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        // 装载率不超过1/2
+        static size_t tableSizeFor(size_t count)
+        {
+            size_t size = 16;
+            while (size < count * 2)
+                size <<= 1;
+            return size;
+        }
+
+        Slot *findSlot(const Key &key)
+        {
+            Table *table = table_.load(std::memory_order_relaxed);
+            uint64_t hash = hashOf(key);
+            size_t index = hash & table->mask;
+            for (size_t probe = 0; probe <= table->mask; ++probe, index = (index + 1) & table->mask)
+            {
+                Slot &slot = table->slots[index];
+                Node *node = slot.node.load(std::memory_order_relaxed);
+                if (!node)
+                    return nullptr;
+                if (node != tombstone() && slot.hash.load(std::memory_order_relaxed) == hash && node->key == key)
+                    return &slot;
+            }
+            return nullptr;
+        }
+
+        // 把存活的节点搬到新表并发布，旧表交给epoch回收
+        Table *rebuild(size_t size)
+        {
+            Table *old = table_.load(std::memory_order_relaxed);
+            Table *table = new Table(size);
+            for (size_t i = 0; i <= old->mask; i++)
+            {
+                Node *node = old->slots[i].node.load(std::memory_order_relaxed);
+                if (!node || node == tombstone())
+                    continue;
+                uint64_t hash = old->slots[i].hash.load(std::memory_order_relaxed);
+                size_t index = hash & table->mask;
+                while (table->slots[index].node.load(std::memory_order_relaxed))
+                    index = (index + 1) & table->mask;
+                table->slots[index].hash.store(hash, std::memory_order_relaxed);
+                table->slots[index].node.store(node, std::memory_order_relaxed);
+            }
+            used_ = live_.load(std::memory_order_relaxed);
+            table_.store(table, std::memory_order_release);
+            reclaimer_.retire(old);
+            return table;
+        }
+
+        std::atomic<Table *> table_;
+        std::atomic<size_t> live_; // 存活的key数
+        size_t used_;              // 非空槽位数(含墓碑)，只由写者访问
+        EpochReclaimer reclaimer_;
+    };
+}
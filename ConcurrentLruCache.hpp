@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "ConcurrentHashIndex.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace MyCache
+{
+    /* 读无锁的近似LRU(CLOCK/二次机会)：
+       - get在epoch保护下查并发哈希索引，命中只置位节点的访问标记，不加锁也不修改任何链表；
+       - put/remove由写锁串行化，淘汰时时钟指针扫过环形数组，跳过并清除有访问标记的节点；
+       - 节点创建后key和value不再修改，更新value时换一个新节点，旧节点通过epoch回收，
+         因此读者拷贝value时不会与写者冲突。 */
+    template <typename Key, typename Value>
+    class ConcurrentLruCache : public CachePolicy<Key, Value>
+    {
+    public:
+        explicit ConcurrentLruCache(size_t capacity)
+            : capacity_(capacity), index_(capacity), clock_(capacity, nullptr), size_(0), hand_(0) {}
+
+        ~ConcurrentLruCache() override
+        {
+            for (size_t i = 0; i < size_; i++)
+                delete clock_[i];
+        }
+
+        void put(Key key, Value value) override
+        {
+            if (capacity_ == 0)
+                return;
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            Node *node = new Node(key, value);
+            Node *old = index_.find(key);
+            if (old)
+            {
+                node->clockIndex = old->clockIndex;
+                node->referenced.store(true, std::memory_order_relaxed);
+                clock_[node->clockIndex] = node;
+                index_.replace(key, node);
+                index_.reclaimer().retire(old);
+                return;
+            }
+            node->clockIndex = size_ < capacity_ ? size_++ : evict();
+            clock_[node->clockIndex] = node;
+            index_.insert(key, node);
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            auto guard = index_.reclaimer().pin();
+            Node *node = index_.find(key);
+            if (!node)
+                return false;
+            // 已置位时不再写，避免热点节点的缓存行在核间来回
+            if (!node->referenced.load(std::memory_order_relaxed))
+                node->referenced.store(true, std::memory_order_relaxed);
+            value = node->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            Node *node = index_.erase(key);
+            if (!node)
+                return;
+            // 用最后一个节点填补空位，保持环形数组紧凑
+            Node *last = clock_[--size_];
+            clock_[node->clockIndex] = last;
+            last->clockIndex = node->clockIndex;
+            clock_[size_] = nullptr;
+            if (hand_ >= size_)
+                hand_ = 0;
+            index_.reclaimer().retire(node);
+        }
+
+        size_t size() const { return index_.size(); }
+
+    private:
+        struct Node
+        {
+            Node(const Key &key, const Value &value) : referenced(false), clockIndex(0), key(key), value(value) {}
+
+            // 读路径设置的访问标记和写者使用的位置放在最前面，小key/value与它们同在一个缓存行
+            std::atomic<bool> referenced; // 上次扫过之后是否被访问过
+            size_t clockIndex;            // 在环形数组中的位置，只由写者访问
+            const Key key;
+            const Value value;
+        };
+
+        // 淘汰一个节点并返回空出的位置
+        size_t evict()
+        {
+            while (true)
+            {
+                size_t index = hand_;
+                Node *node = clock_[index];
+                hand_ = hand_ + 1 < size_ ? hand_ + 1 : 0;
+                if (node->referenced.load(std::memory_order_relaxed))
+                {
+                    node->referenced.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                index_.erase(node->key);
+                index_.reclaimer().retire(node);
+                return index;
+            }
+        }
+
+        size_t capacity_;
+        ConcurrentHashIndex<Key, Node> index_;
+        std::mutex writeMutex_;
+        std::vector<Node *> clock_; // 时钟环，只由写者访问
+        size_t size_;
+        size_t hand_; // 时钟指针
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../LruCache.hpp"
+#include <memory>
+#include <vector>
+
+namespace MyCache
+{
+    // 分布式缓存中的一个节点，实现需要线程安全
+    template <typename Key, typename Value>
+    class CacheNode
+    {
+    public:
+        virtual ~CacheNode() = default;
+
+        virtual void put(const Key &key, const Value &value) = 0;
+        virtual bool get(const Key &key, Value &value) = 0;
+
+        // 批量读取：values和found与keys一一对应；远程节点应重写为一次往返
+        virtual void multiGet(const std::vector<Key> &keys, std::vector<Value> &values, std::vector<bool> &found)
+        {
+            values.assign(keys.size(), Value{});
+            found.assign(keys.size(), false);
+            for (size_t i = 0; i < keys.size(); ++i)
+                found[i] = get(keys[i], values[i]);
+        }
+    };
+
+    // 进程内节点：每个节点是一个独立的HashLruCache，用于测试和模拟节点增减
+    template <typename Key, typename Value>
+    class LocalCacheNode : public CacheNode<Key, Value>
+    {
+    public:
+        LocalCacheNode(size_t capacity, int sliceNum) : cache_(capacity, sliceNum) {}
+
+        void put(const Key &key, const Value &value) override { cache_.put(key, value); }
+        bool get(const Key &key, Value &value) override { return cache_.get(key, value); }
+
+    private:
+        HashLruCache<Key, Value> cache_;
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "../CachePolicy.h"
+#include "../HashMix.h"
+#include "CacheNode.hpp"
+#include "HashRing.hpp"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace MyCache
+{
+    /* 客户端分布式缓存：按一致性哈希环把key分到多个节点，对外仍是CachePolicy接口。
+       节点可以是进程内的LocalCacheNode，也可以是通过socket访问的MemcacheNode。
+       增删节点只影响约1/N的key，这些key在新节点上第一次访问会未命中，之后重新填充；
+       节点被移除后持有的数据随之丢失，不做迁移。成员变更与读写用读写锁隔开，读写只加共享锁。
+       key用StableHash定位(见HashMix.h)，与节点名一样不依赖std::hash，不同标准库编译出的客户端把同一个key分到同一个节点。 */
+    template <typename Key, typename Value>
+    class DistributedCache : public CachePolicy<Key, Value>
+    {
+    public:
+        using Node = CacheNode<Key, Value>;
+
+        explicit DistributedCache(int virtualNodes = 160) : ring_(virtualNodes) {}
+
+        bool addNode(const std::string &name, std::shared_ptr<Node> node)
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+            return ring_.addNode(name, std::move(node));
+        }
+
+        bool removeNode(const std::string &name)
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(mutex_);
+            return ring_.removeNode(name);
+        }
+
+        // 没有节点时put被忽略
+        void put(Key key, Value value) override
+        {
+            std::shared_ptr<Node> node = nodeFor(key);
+            if (node)
+                node->put(key, value);
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::shared_ptr<Node> node = nodeFor(key);
+            return node && node->get(key, value);
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /* 批量读取：先按节点分组，再对每个节点调用一次multiGet，
+           远程节点上一批key只需一次往返。values和found与keys一一对应。 */
+        void multiGet(const std::vector<Key> &keys, std::vector<Value> &values, std::vector<bool> &found)
+        {
+            values.assign(keys.size(), Value{});
+            found.assign(keys.size(), false);
+            std::vector<Batch> batches;
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+                if (ring_.empty())
+                    return;
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    const std::shared_ptr<Node> &node = ring_.nodeFor(hash(keys[i]));
+                    size_t b = 0;
+                    while (b < batches.size() && batches[b].node != node)
+                        b++;
+                    if (b == batches.size())
+                        batches.push_back(Batch{node, {}, {}});
+                    batches[b].keys.push_back(keys[i]);
+                    batches[b].positions.push_back(i);
+                }
+            }
+            std::vector<Value> batchValues;
+            std::vector<bool> batchFound;
+            for (Batch &batch : batches)
+            {
+                batch.node->multiGet(batch.keys, batchValues, batchFound);
+                for (size_t j = 0; j < batch.positions.size(); ++j)
+                {
+                    if (batchFound[j])
+                    {
+                        values[batch.positions[j]] = std::move(batchValues[j]);
+                        found[batch.positions[j]] = true;
+                    }
+                }
+            }
+        }
+
+        // key当前所在的节点名，没有节点时返回空字符串
+        std::string nodeNameOf(const Key &key)
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+            return ring_.empty() ? std::string() : ring_.nameFor(hash(key));
+        }
+
+        size_t nodeCount()
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+            return ring_.size();
+        }
+
+    private:
+        struct Batch
+        {
+            std::shared_ptr<Node> node;
+            std::vector<Key> keys;
+            std::vector<size_t> positions; // 在调用方keys中的下标
+        };
+
+        static uint64_t hash(const Key &key) { return StableHash<Key>()(key); }
+
+        // 返回节点的副本，节点在操作期间被移除也不会析构
+        std::shared_ptr<Node> nodeFor(const Key &key)
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+            if (ring_.empty())
+                return nullptr;
+            return ring_.nodeFor(hash(key));
+        }
+
+        HashRing<std::shared_ptr<Node>> ring_;
+        std::shared_timed_mutex mutex_;
+    };
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../HashMix.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MyCache
+{
+    /* 带虚拟节点的一致性哈希环：每个节点在环上放virtualNodes个点，key顺时针落到第一个点所属的节点。
+       增加一个节点只会接管各节点的一小段，约1/N的key换节点；取模哈希则几乎所有key都会换节点。
+       点的位置只由节点名决定，各个客户端按同样的成员列表建环就得到同样的映射。
+       Node为节点的句柄(如shared_ptr)，直接存在环上，查找时不再经过名字。
+       查找是对排好序的数组二分，O(log(N * virtualNodes))。不加锁，由调用方保证修改和查找不并发。 */
+    template <typename Node>
+    class HashRing
+    {
+    public:
+        explicit HashRing(int virtualNodes = 160) : virtualNodes_(std::max(1, virtualNodes)) {}
+
+        // 节点名已存在时返回false
+        bool addNode(const std::string &name, Node node)
+        {
+            for (const auto &member : members_)
+            {
+                if (member.first == name)
+                    return false;
+            }
+            members_.emplace_back(name, node);
+            for (int i = 0; i < virtualNodes_; ++i)
+                points_.push_back(Point{pointHash(name, i), members_.size() - 1});
+            sortPoints();
+            return true;
+        }
+
+        bool removeNode(const std::string &name)
+        {
+            size_t index = 0;
+            while (index < members_.size() && members_[index].first != name)
+                index++;
+            if (index == members_.size())
+                return false;
+            members_.erase(members_.begin() + index);
+            points_.erase(std::remove_if(points_.begin(), points_.end(),
+                                         [index](const Point &point)
+                                         { return point.member == index; }),
+                          points_.end());
+            for (Point &point : points_)
+            {
+                if (point.member > index)
+                    point.member--;
+            }
+            return true;
+        }
+
+        // keyHash为key的哈希值，内部会再混淆一次，std::hash<int>这类恒等哈希也能均匀分布；环为空时不能调用
+        const Node &nodeFor(uint64_t keyHash) const
+        {
+            return members_[points_[pointFor(keyHash)].member].second;
+        }
+
+        const std::string &nameFor(uint64_t keyHash) const
+        {
+            return members_[points_[pointFor(keyHash)].member].first;
+        }
+
+        size_t size() const { return members_.size(); }
+        bool empty() const { return members_.empty(); }
+        const std::vector<std::pair<std::string, Node>> &members() const { return members_; }
+
+    private:
+        struct Point
+        {
+            uint64_t hash;
+            size_t member; // members_中的下标
+        };
+
+        size_t pointFor(uint64_t keyHash) const
+        {
+            uint64_t position = mixKey(keyHash);
+            auto it = std::lower_bound(points_.begin(), points_.end(), position,
+                                       [](const Point &point, uint64_t value)
+                                       { return point.hash < value; });
+            return it == points_.end() ? 0 : it - points_.begin();
+        }
+
+        void sortPoints()
+        {
+            std::sort(points_.begin(), points_.end(),
+                      [](const Point &a, const Point &b)
+                      { return a.hash < b.hash; });
+        }
+
+        // 节点名用FNV-1a而不是std::hash，不同标准库编译出的客户端也能得到同样的环
+        static uint64_t pointHash(const std::string &name, int replica)
+        {
+            return mixKey(fnv1a(name.data(), name.size()) ^ mixKey(static_cast<uint64_t>(replica) + 1));
+        }
+
+        int virtualNodes_;
+        std::vector<std::pair<std::string, Node>> members_;
+        std::vector<Point> points_; // 按哈希值排序
+    };
+}
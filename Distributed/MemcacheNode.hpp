@@ -0,0 +1,206 @@
+#pragma once
+
+#include "CacheNode.hpp"
+#include "../Server/MemcacheProtocol.hpp"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace MyCache
+{
+    /* 远程节点：通过memcached文本协议访问一个MyCacheServer(或memcached)进程。
+       每个节点一条阻塞连接，请求串行发出。multiGet把发往该节点的key按行长上限(MemcacheParser::kMaxLineLength)
+       分成若干条get命令，在同一连接上一次发出再依次读回，批量再大也只需一次往返。
+       连接断开时本次操作按未命中处理，下次操作重新连接。 */
+    class MemcacheNode : public CacheNode<std::string, std::string>
+    {
+    public:
+        MemcacheNode(std::string host, int port) : host_(std::move(host)), port_(port), fd_(-1), begin_(0) {}
+
+        ~MemcacheNode() override { disconnect(); }
+
+        void put(const std::string &key, const std::string &value) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string request = "set " + key + " 0 0 " + std::to_string(value.size()) + "\r\n";
+            request.append(value).append("\r\n");
+            std::string line;
+            if (!send(request) || !readLine(line) || line != "STORED")
+                disconnect();
+        }
+
+        bool get(const std::string &key, std::string &value) override
+        {
+            std::vector<std::string> values;
+            std::vector<bool> found;
+            multiGet(std::vector<std::string>{key}, values, found);
+            value = std::move(values[0]);
+            return found[0];
+        }
+
+        void multiGet(const std::vector<std::string> &keys, std::vector<std::string> &values, std::vector<bool> &found) override
+        {
+            values.assign(keys.size(), std::string());
+            found.assign(keys.size(), false);
+            if (keys.empty())
+                return;
+            std::unordered_map<std::string, std::vector<size_t>> positions; // 同一个key可能出现多次
+            std::string request;
+            size_t lineStart = 0, lines = 0;
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                // 加上这个key会超出行长上限时另起一条get命令
+                if (request.size() > lineStart && request.size() - lineStart + 1 + keys[i].size() + 2 > MemcacheParser::kMaxLineLength)
+                {
+                    request.append("\r\n");
+                    lineStart = request.size();
+                }
+                if (request.size() == lineStart)
+                {
+                    request.append("get");
+                    lines++;
+                }
+                request.append(" ").append(keys[i]);
+                positions[keys[i]].push_back(i);
+            }
+            request.append("\r\n");
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!send(request))
+                return;
+            std::string line, data;
+            while (readLine(line))
+            {
+                // 每条get命令的回复以END结束
+                if (line == "END")
+                {
+                    if (--lines == 0)
+                        return;
+                    continue;
+                }
+                char key[256];
+                unsigned flags;
+                size_t bytes;
+                if (std::sscanf(line.c_str(), "VALUE %255s %u %zu", key, &flags, &bytes) != 3 || !readBytes(bytes + 2, data))
+                    break;
+                auto it = positions.find(key);
+                if (it == positions.end())
+                    continue;
+                data.resize(bytes);
+                for (size_t index : it->second)
+                {
+                    values[index] = data;
+                    found[index] = true;
+                }
+            }
+            // 回复不完整时丢弃连接，已解析的结果仍然有效
+            disconnect();
+        }
+
+    private:
+        bool connect()
+        {
+            fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd_ < 0)
+                return false;
+            sockaddr_in addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port_));
+            if (::inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1 ||
+                ::connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+            {
+                disconnect();
+                return false;
+            }
+            int on = 1;
+            ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            return true;
+        }
+
+        void disconnect()
+        {
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = -1;
+            buffer_.clear();
+            begin_ = 0;
+        }
+
+        bool send(const std::string &data)
+        {
+            if (fd_ < 0 && !connect())
+                return false;
+            size_t sent = 0;
+            while (sent < data.size())
+            {
+                ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0)
+                {
+                    disconnect();
+                    return false;
+                }
+                sent += n;
+            }
+            return true;
+        }
+
+        bool readLine(std::string &line)
+        {
+            while (true)
+            {
+                size_t pos = buffer_.find("\r\n", begin_);
+                if (pos != std::string::npos)
+                {
+                    line.assign(buffer_, begin_, pos - begin_);
+                    begin_ = pos + 2;
+                    return true;
+                }
+                if (!fill())
+                    return false;
+            }
+        }
+
+        bool readBytes(size_t size, std::string &data)
+        {
+            while (buffer_.size() - begin_ < size)
+            {
+                if (!fill())
+                    return false;
+            }
+            data.assign(buffer_, begin_, size);
+            begin_ += size;
+            return true;
+        }
+
+        bool fill()
+        {
+            if (fd_ < 0)
+                return false;
+            buffer_.erase(0, begin_);
+            begin_ = 0;
+            char chunk[16 * 1024];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                return false;
+            buffer_.append(chunk, n);
+            return true;
+        }
+
+        std::string host_;
+        int port_;
+        int fd_;
+        std::string buffer_; // 已收到但未解析的回复
+        size_t begin_;
+        std::mutex mutex_;
+    };
+}
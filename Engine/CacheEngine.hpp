@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../CacheLock.h"
+#include "../CachePolicy.h"
+#include "EngineStore.hpp"
+#include "InlineString.hpp"
+#include "StatsPolicies.hpp"
+#include <cstddef>
+#include <mutex>
+
+namespace MyCache
+{
+    /* 基于策略组合的缓存引擎：索引、淘汰、锁、统计都是模板参数，热路径上没有虚函数调用。
+       节点只分配一次，淘汰策略需要的链表指针以Hook的形式直接嵌入节点(见EngineStore)。
+       例如CacheEngine<K, V, HashIndex, LruEviction, NullLock, NoStats>在单线程下
+       编译后只剩哈希表查找和链表指针操作。
+       对外接口来自StaticCachePolicy，需要虚接口时用VirtualCacheAdapter包装。 */
+    template <typename Key, typename Value,
+              template <typename, typename> class Index = HashIndex,
+              typename Eviction = LruEviction,
+              typename Lock = std::mutex,
+              typename Stats = NoStats>
+    class CacheEngine : public StaticCachePolicy<CacheEngine<Key, Value, Index, Eviction, Lock, Stats>, Key, Value>
+    {
+        friend class StaticCachePolicy<CacheEngine, Key, Value>;
+
+    public:
+        using Store = EngineStore<Key, Value, Index, Eviction>;
+        using Node = typename Store::Node;
+
+        explicit CacheEngine(size_t capacity) : capacity_(capacity), store_(capacity) {}
+
+        CacheEngine(const CacheEngine &) = delete;
+        CacheEngine &operator=(const CacheEngine &) = delete;
+
+        bool remove(const Key &key)
+        {
+            std::lock_guard<Lock> lock(lock_);
+            Node *node = store_.find(key);
+            if (!node)
+                return false;
+            store_.erase(node);
+            return true;
+        }
+
+        size_t size() const
+        {
+            std::lock_guard<Lock> lock(lock_);
+            return store_.size();
+        }
+
+        size_t capacity() const { return capacity_; }
+
+        Stats stats() const
+        {
+            std::lock_guard<Lock> lock(lock_);
+            return stats_;
+        }
+
+    private:
+        void putImpl(const Key &key, const Value &value)
+        {
+            if (capacity_ == 0)
+                return;
+            std::lock_guard<Lock> lock(lock_);
+            Node *node = store_.find(key);
+            if (node)
+            {
+                node->value = value;
+                store_.access(node);
+                return;
+            }
+            if (store_.size() >= capacity_)
+                evictOne();
+            store_.insert(key, value);
+        }
+
+        bool getImpl(const Key &key, Value &value)
+        {
+            std::lock_guard<Lock> lock(lock_);
+            Node *node = store_.find(key);
+            if (!node)
+            {
+                stats_.onMiss();
+                return false;
+            }
+            stats_.onHit();
+            store_.access(node);
+            value = node->value;
+            return true;
+        }
+
+        void evictOne()
+        {
+            Node *victim = store_.victim();
+            if (!victim)
+                return;
+            store_.erase(victim);
+            stats_.onEviction();
+        }
+
+        size_t capacity_;
+        Store store_;
+        Stats stats_;
+        mutable Lock lock_;
+    };
+
+    // 常用组合，Lock取NullLock即为单线程版本
+    template <typename Key, typename Value, typename Lock = std::mutex, typename Stats = NoStats>
+    using EngineLruCache = CacheEngine<Key, Value, HashIndex, LruEviction, Lock, Stats>;
+
+    template <typename Key, typename Value, typename Lock = std::mutex, typename Stats = NoStats>
+    using EngineLfuCache = CacheEngine<Key, Value, HashIndex, LfuEviction, Lock, Stats>;
+
+    // 字符串key的紧凑组合：短key内联在节点里，索引只存指纹和节点指针，每个条目的key只有一份
+    template <typename Value, size_t N = 24, typename Lock = std::mutex, typename Stats = NoStats>
+    using CompactLruCache = CacheEngine<InlineString<N>, Value, FingerprintIndex, LruEviction, Lock, Stats>;
+
+    template <typename Value, size_t N = 24, typename Lock = std::mutex, typename Stats = NoStats>
+    using CompactLfuCache = CacheEngine<InlineString<N>, Value, FingerprintIndex, LfuEviction, Lock, Stats>;
+}
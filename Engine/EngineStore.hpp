@@ -0,0 +1,132 @@
+#pragma once
+
+#include "../NodeLayout.h"
+#include "EvictionPolicies.hpp"
+#include "IndexPolicies.hpp"
+#include <cstddef>
+#include <memory>
+
+namespace MyCache
+{
+    // 节点上默认没有附加字段(空基类不占空间)
+    struct NoNodeExtra
+    {
+    };
+
+    // 遍历游标标记：游标是挂在淘汰顺序里、不进索引的哨兵节点，淘汰和遍历时跳过
+    struct CursorMark
+    {
+        bool cursor = false;
+    };
+
+    /* 不加锁的存储核心：索引 + 淘汰顺序 + 节点分配，调用方负责加锁。
+       CacheEngine在外面加上锁和统计；LruCache/LfuCache也建在它上面，只另外实现容量调整、后台维护和遍历游标。
+       节点由Alloc(按Node重新绑定)分配，链表指针(Hook)和附加字段(Extra)排在key/value前面。
+       析构时沿淘汰顺序逐个释放，节点再多也不会递归析构。 */
+    template <typename Key, typename Value,
+              template <typename, typename> class Index = HashIndex,
+              typename Eviction = LruEviction,
+              typename Extra = NoNodeExtra,
+              typename Alloc = std::allocator<char>>
+    class EngineStore
+    {
+    public:
+        struct Node : Eviction::template Hook<Node>, Extra
+        {
+            Node(const Key &key, const Value &value) : key(key), value(value) {}
+
+            Key key;
+            Value value;
+        };
+
+        using EvictionPolicy = typename Eviction::template Policy<Node>;
+
+        static_assert(sizeof(typename Eviction::template Hook<Node>) + sizeof(Extra) <= kCacheLineSize, "淘汰策略的Hook超出一个缓存行");
+
+        explicit EngineStore(size_t capacity = 0, const Alloc &alloc = Alloc()) : index_(capacity), alloc_(alloc) {}
+
+        ~EngineStore() { destroyAll(); }
+
+        EngineStore(const EngineStore &) = delete;
+        EngineStore &operator=(const EngineStore &) = delete;
+
+        Node *find(const Key &key) const { return index_.find(key); }
+
+        size_t size() const { return index_.size(); }
+
+        // key必须不存在
+        Node *insert(const Key &key, const Value &value)
+        {
+            Node *node = create(key, value);
+            index_.insert(key, node);
+            eviction_.onInsert(node);
+            return node;
+        }
+
+        void access(Node *node) { eviction_.onAccess(node); }
+
+        // 从索引和淘汰顺序中摘除并释放
+        void erase(Node *node)
+        {
+            index_.erase(node->key);
+            eviction_.onRemove(node);
+            destroy(node);
+        }
+
+        Node *victim() const { return eviction_.victim(); }
+
+        // 预留能放下capacity个key的索引空间
+        void reserve(size_t capacity) { index_.reserve(capacity); }
+
+        // 释放所有节点(包括挂在淘汰顺序里的游标)
+        void clear()
+        {
+            index_.clear();
+            destroyAll();
+        }
+
+        // 不进索引的节点(如遍历游标)直接用create/destroy，通过order()挂到淘汰顺序里
+        Node *create(const Key &key, const Value &value)
+        {
+            Node *node = NodeTraits::allocate(alloc_, 1);
+            try
+            {
+                NodeTraits::construct(alloc_, node, key, value);
+            }
+            catch (...)
+            {
+                NodeTraits::deallocate(alloc_, node, 1);
+                throw;
+            }
+            return node;
+        }
+
+        void destroy(Node *node)
+        {
+            NodeTraits::destroy(alloc_, node);
+            NodeTraits::deallocate(alloc_, node, 1);
+        }
+
+        EvictionPolicy &order() { return eviction_; }
+
+        // 更换节点的分配器，只能在没有节点时调用
+        void setAllocator(const Alloc &alloc) { alloc_ = NodeAllocator(alloc); }
+
+    private:
+        using NodeAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+        using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+        void destroyAll()
+        {
+            while (Node *node = eviction_.victim())
+            {
+                eviction_.onRemove(node);
+                destroy(node);
+            }
+        }
+
+        Index<Key, Node> index_;
+        EvictionPolicy eviction_;
+        NodeAllocator alloc_;
+    };
+}
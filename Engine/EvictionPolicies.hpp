@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+
+namespace MyCache
+{
+    /* 淘汰策略由两部分组成：
+       - Hook<Node>：嵌入到节点中的侵入式字段，节点本身只分配一次；
+       - Policy<Node>：维护淘汰顺序，接口为onInsert/onAccess/onRemove/victim，全部O(1)。
+       victim只返回候选节点，真正的移除由引擎调用onRemove完成。
+       Hook的字段是公开的，LruCache/LfuCache的遍历游标沿它们行走，并用insertAfter把游标挂到指定位置。 */
+
+    // LRU：单条侵入式双向链表，头部最近访问，尾部为淘汰候选
+    struct LruEviction
+    {
+        template <typename Node>
+        struct Hook
+        {
+            Node *prev = nullptr;
+            Node *next = nullptr;
+        };
+
+        template <typename Node>
+        class Policy
+        {
+        public:
+            Policy() = default;
+            Policy(const Policy &) = delete;
+            Policy &operator=(const Policy &) = delete;
+
+            void onInsert(Node *node) { pushFront(node); }
+
+            void onAccess(Node *node)
+            {
+                if (node == head_)
+                    return;
+                unlink(node);
+                pushFront(node);
+            }
+
+            void onRemove(Node *node) { unlink(node); }
+
+            Node *victim() const { return tail_; }
+
+            // 最近访问的一端，沿next走向淘汰端
+            Node *front() const { return head_; }
+
+            // 把node挂在pos后面(更靠近淘汰端)，pos为空时挂到头部
+            void insertAfter(Node *pos, Node *node)
+            {
+                if (!pos)
+                {
+                    pushFront(node);
+                    return;
+                }
+                node->prev = pos;
+                node->next = pos->next;
+                if (pos->next)
+                    pos->next->prev = node;
+                else
+                    tail_ = node;
+                pos->next = node;
+            }
+
+        private:
+            void pushFront(Node *node)
+            {
+                node->prev = nullptr;
+                node->next = head_;
+                if (head_)
+                    head_->prev = node;
+                else
+                    tail_ = node;
+                head_ = node;
+            }
+
+            void unlink(Node *node)
+            {
+                if (node->prev)
+                    node->prev->next = node->next;
+                else
+                    head_ = node->next;
+                if (node->next)
+                    node->next->prev = node->prev;
+                else
+                    tail_ = node->prev;
+                node->prev = node->next = nullptr;
+            }
+
+            Node *head_ = nullptr;
+            Node *tail_ = nullptr;
+        };
+    };
+
+    /* LFU：按频次升序串起的桶链表，每个桶内是一条节点链表(头部最新)。
+       访问时节点移动到频次+1的桶，不存在则紧跟当前桶新建，因此淘汰和访问都是O(1)；
+       淘汰候选为最小频次桶中最久未访问的节点。空桶放回空闲链表复用。 */
+    struct LfuEviction
+    {
+        template <typename Node>
+        struct Bucket
+        {
+            int freq = 0;
+            Node *head = nullptr;
+            Node *tail = nullptr;
+            Bucket *prev = nullptr;
+            Bucket *next = nullptr;
+        };
+
+        template <typename Node>
+        struct Hook
+        {
+            Node *prev = nullptr;
+            Node *next = nullptr;
+            Bucket<Node> *bucket = nullptr;
+        };
+
+        template <typename Node>
+        class Policy
+        {
+        public:
+            using BucketType = Bucket<Node>;
+
+            Policy() = default;
+            Policy(const Policy &) = delete;
+            Policy &operator=(const Policy &) = delete;
+
+            ~Policy()
+            {
+                freeBucketList(head_);
+                freeBucketList(freeBuckets_);
+            }
+
+            void onInsert(Node *node)
+            {
+                BucketType *bucket = head_;
+                if (!bucket || bucket->freq != 1)
+                    bucket = insertBucketAfter(nullptr, 1);
+                pushFront(bucket, node);
+            }
+
+            void onAccess(Node *node)
+            {
+                BucketType *bucket = node->bucket;
+                BucketType *next = bucket->next;
+                if (!next || next->freq != bucket->freq + 1)
+                    next = insertBucketAfter(bucket, bucket->freq + 1);
+                unlink(node);
+                pushFront(next, node);
+                if (!bucket->head)
+                    removeBucket(bucket);
+            }
+
+            void onRemove(Node *node)
+            {
+                BucketType *bucket = node->bucket;
+                unlink(node);
+                if (!bucket->head)
+                    removeBucket(bucket);
+            }
+
+            Node *victim() const { return head_ ? head_->tail : nullptr; }
+
+            static int frequency(const Node *node) { return node->bucket ? node->bucket->freq : 0; }
+
+            // 最小频次桶，沿next走向高频次
+            BucketType *lowest() const { return head_; }
+
+            // 把node挂在bucket中pos的后面(更靠近淘汰端)，pos为空时挂到桶头
+            void insertAfter(BucketType *bucket, Node *pos, Node *node)
+            {
+                if (!pos)
+                {
+                    pushFront(bucket, node);
+                    return;
+                }
+                node->bucket = bucket;
+                node->prev = pos;
+                node->next = pos->next;
+                if (pos->next)
+                    pos->next->prev = node;
+                else
+                    bucket->tail = node;
+                pos->next = node;
+            }
+
+            /* 老化：所有节点的频次减去delta，最小为1。桶保持升序，降到1的桶合并成一个，
+               原频次低的节点更靠近淘汰端；只有被合并的节点需要改桶指针。 */
+            void age(int delta)
+            {
+                BucketType *merged = nullptr;
+                for (BucketType *bucket = head_; bucket;)
+                {
+                    BucketType *next = bucket->next;
+                    bucket->freq = std::max(1, bucket->freq - delta);
+                    if (bucket->freq == 1 && merged)
+                    {
+                        for (Node *node = bucket->head; node; node = node->next)
+                            node->bucket = merged;
+                        bucket->tail->next = merged->head;
+                        merged->head->prev = bucket->tail;
+                        merged->head = bucket->head;
+                        bucket->head = bucket->tail = nullptr;
+                        removeBucket(bucket);
+                    }
+                    else if (bucket->freq == 1)
+                    {
+                        merged = bucket;
+                    }
+                    bucket = next;
+                }
+            }
+
+        private:
+            void pushFront(BucketType *bucket, Node *node)
+            {
+                node->bucket = bucket;
+                node->prev = nullptr;
+                node->next = bucket->head;
+                if (bucket->head)
+                    bucket->head->prev = node;
+                else
+                    bucket->tail = node;
+                bucket->head = node;
+            }
+
+            void unlink(Node *node)
+            {
+                BucketType *bucket = node->bucket;
+                if (node->prev)
+                    node->prev->next = node->next;
+                else
+                    bucket->head = node->next;
+                if (node->next)
+                    node->next->prev = node->prev;
+                else
+                    bucket->tail = node->prev;
+                node->prev = node->next = nullptr;
+                node->bucket = nullptr;
+            }
+
+            // prev为空时插入到链表头部
+            BucketType *insertBucketAfter(BucketType *prev, int freq)
+            {
+                BucketType *bucket = freeBuckets_;
+                if (bucket)
+                    freeBuckets_ = bucket->next;
+                else
+                    bucket = new BucketType();
+                bucket->freq = freq;
+                bucket->head = bucket->tail = nullptr;
+                bucket->prev = prev;
+                bucket->next = prev ? prev->next : head_;
+                if (bucket->next)
+                    bucket->next->prev = bucket;
+                if (prev)
+                    prev->next = bucket;
+                else
+                    head_ = bucket;
+                return bucket;
+            }
+
+            void removeBucket(BucketType *bucket)
+            {
+                if (bucket->prev)
+                    bucket->prev->next = bucket->next;
+                else
+                    head_ = bucket->next;
+                if (bucket->next)
+                    bucket->next->prev = bucket->prev;
+                bucket->prev = nullptr;
+                bucket->next = freeBuckets_;
+                freeBuckets_ = bucket;
+            }
+
+            static void freeBucketList(BucketType *bucket)
+            {
+                while (bucket)
+                {
+                    BucketType *next = bucket->next;
+                    delete bucket;
+                    bucket = next;
+                }
+            }
+
+            BucketType *head_ = nullptr;        // 最小频次桶
+            BucketType *freeBuckets_ = nullptr; // 空闲桶，通过next串起
+        };
+    };
+}
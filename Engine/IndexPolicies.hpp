@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <unordered_map>
+
+namespace MyCache
+{
+    /* 索引策略：key -> 节点指针。接口要求：
+       - Node *find(const Key &key)
+       - void insert(const Key &key, Node *node)   // key不存在时调用
+       - void erase(const Key &key)
+       - size_t size() const
+       调整容量或清空时(见EngineStore)还需要：
+       - void reserve(size_t capacity)             // 预留空间，之后插入到capacity个key不再扩容
+       - void clear() */
+    template <typename Key, typename Node>
+    class HashIndex
+    {
+    public:
+        explicit HashIndex(size_t capacity = 0)
+        {
+            map_.reserve(capacity);
+        }
+
+        Node *find(const Key &key) const
+        {
+            auto it = map_.find(key);
+            return it == map_.end() ? nullptr : it->second;
+        }
+
+        void insert(const Key &key, Node *node) { map_.emplace(key, node); }
+
+        void erase(const Key &key) { map_.erase(key); }
+
+        size_t size() const { return map_.size(); }
+
+        void reserve(size_t capacity)
+        {
+            if (capacity > map_.bucket_count() * map_.max_load_factor())
+                map_.reserve(capacity);
+        }
+
+        void clear() { map_.clear(); }
+
+    private:
+        std::unordered_map<Key, Node *> map_;
+    };
+
+    /* 指纹索引：开放寻址表只保存32位指纹和节点指针(每槽12字节)，key只存在节点里。
+       查找时先比较指纹，指纹相同再比较节点中的key；删除留下墓碑，墓碑过多或装载率过高时重建。
+       Node需要有key成员。 */
+    template <typename Key, typename Node>
+    class FingerprintIndex
+    {
+    public:
+        explicit FingerprintIndex(size_t capacity = 0) : size_(0), used_(0)
+        {
+            resize(tableSizeFor(capacity));
+        }
+
+        Node *find(const Key &key) const
+        {
+            uint32_t tag;
+            size_t index = locate(key, tag);
+            for (size_t probe = 0; probe <= mask_; ++probe, index = (index + 1) & mask_)
+            {
+                if (tags_[index] == kEmpty)
+                    return nullptr;
+                if (tags_[index] == tag && nodes_[index]->key == key)
+                    return nodes_[index];
+            }
+            return nullptr;
+        }
+
+        // key必须不存在
+        void insert(const Key &key, Node *node)
+        {
+            if ((used_ + 1) * 4 > (mask_ + 1) * 3)
+                rebuild(tableSizeFor(size_ + 1));
+            uint32_t tag;
+            size_t index = locate(key, tag);
+            while (tags_[index] != kEmpty && tags_[index] != kTombstone)
+                index = (index + 1) & mask_;
+            if (tags_[index] == kEmpty)
+                used_++;
+            tags_[index] = tag;
+            nodes_[index] = node;
+            size_++;
+        }
+
+        void erase(const Key &key)
+        {
+            uint32_t tag;
+            size_t index = locate(key, tag);
+            for (size_t probe = 0; probe <= mask_; ++probe, index = (index + 1) & mask_)
+            {
+                if (tags_[index] == kEmpty)
+                    return;
+                if (tags_[index] == tag && nodes_[index]->key == key)
+                {
+                    tags_[index] = kTombstone;
+                    nodes_[index] = nullptr;
+                    size_--;
+                    return;
+                }
+            }
+        }
+
+        size_t size() const { return size_; }
+
+        void reserve(size_t capacity)
+        {
+            size_t size = tableSizeFor(capacity);
+            if (size > mask_ + 1)
+                rebuild(size);
+        }
+
+        void clear()
+        {
+            resize(mask_ + 1);
+            size_ = used_ = 0;
+        }
+
+    private:
+        static constexpr uint32_t kEmpty = 0;
+        static constexpr uint32_t kTombstone = 1;
+
+        // 返回起始槽位，tag为避开0和1的指纹
+        size_t locate(const Key &key, uint32_t &tag) const
+        {
+            uint64_t hash = std::hash<Key>()(key);
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            tag = static_cast<uint32_t>(hash >> 32);
+            if (tag <= kTombstone)
+                tag += 2;
+            return static_cast<size_t>(hash) & mask_;
+        }
+
+        // 装载率不超过1/2
+        static size_t tableSizeFor(size_t count)
+        {
+            size_t size = 16;
+            while (size < count * 2)
+                size <<= 1;
+            return size;
+        }
+
+        void resize(size_t size)
+        {
+            mask_ = size - 1;
+            tags_.assign(size, kEmpty);
+            nodes_.assign(size, nullptr);
+        }
+
+        void rebuild(size_t size)
+        {
+            std::vector<uint32_t> oldTags;
+            std::vector<Node *> oldNodes;
+            oldTags.swap(tags_);
+            oldNodes.swap(nodes_);
+            resize(size);
+            size_ = used_ = 0;
+            for (size_t i = 0; i < oldTags.size(); i++)
+            {
+                if (oldTags[i] != kEmpty && oldTags[i] != kTombstone)
+                    insert(oldNodes[i]->key, oldNodes[i]);
+            }
+        }
+
+        std::vector<uint32_t> tags_; // 指纹，0为空槽，1为墓碑
+        std::vector<Node *> nodes_;
+        size_t mask_;
+        size_t size_; // 存活的key数
+        size_t used_; // 非空槽位数(含墓碑)
+    };
+
+    template <typename Key, typename Node>
+    constexpr uint32_t FingerprintIndex<Key, Node>::kEmpty;
+
+    template <typename Key, typename Node>
+    constexpr uint32_t FingerprintIndex<Key, Node>::kTombstone;
+}
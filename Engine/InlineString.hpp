@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+namespace MyCache
+{
+    /* 定长内联的字符串key：不超过N字节的key直接存放在对象内部，不做堆分配；
+       更长的key只做一次精确大小的堆分配。放在缓存节点里时key只存这一份。 */
+    template <size_t N = 24>
+    class InlineString
+    {
+    public:
+        InlineString() : size_(0) {}
+
+        InlineString(const char *data, size_t size) { assign(data, size); }
+
+        InlineString(const char *text) : InlineString(text, std::strlen(text)) {}
+
+        InlineString(const std::string &text) : InlineString(text.data(), text.size()) {}
+
+        InlineString(const InlineString &other) { assign(other.data(), other.size_); }
+
+        InlineString(InlineString &&other) noexcept : size_(other.size_)
+        {
+            if (isInline())
+                std::memcpy(storage_.buffer, other.storage_.buffer, size_);
+            else
+                storage_.heap = other.storage_.heap;
+            other.size_ = 0;
+        }
+
+        InlineString &operator=(const InlineString &other)
+        {
+            if (this != &other)
+            {
+                release();
+                assign(other.data(), other.size_);
+            }
+            return *this;
+        }
+
+        InlineString &operator=(InlineString &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                size_ = other.size_;
+                if (isInline())
+                    std::memcpy(storage_.buffer, other.storage_.buffer, size_);
+                else
+                    storage_.heap = other.storage_.heap;
+                other.size_ = 0;
+            }
+            return *this;
+        }
+
+        ~InlineString() { release(); }
+
+        const char *data() const { return isInline() ? storage_.buffer : storage_.heap; }
+        size_t size() const { return size_; }
+        bool isInline() const { return size_ <= N; }
+        std::string str() const { return std::string(data(), size_); }
+
+        bool operator==(const InlineString &other) const
+        {
+            return size_ == other.size_ && std::memcmp(data(), other.data(), size_) == 0;
+        }
+
+        bool operator!=(const InlineString &other) const { return !(*this == other); }
+
+    private:
+        void assign(const char *data, size_t size)
+        {
+            size_ = size;
+            if (isInline())
+            {
+                std::memcpy(storage_.buffer, data, size);
+            }
+            else
+            {
+                storage_.heap = new char[size];
+                std::memcpy(storage_.heap, data, size);
+            }
+        }
+
+        void release()
+        {
+            if (!isInline())
+                delete[] storage_.heap;
+            size_ = 0;
+        }
+
+        size_t size_;
+        union
+        {
+            char buffer[N];
+            char *heap;
+        } storage_;
+    };
+}
+
+namespace std
+{
+    template <size_t N>
+    struct hash<MyCache::InlineString<N>>
+    {
+        // FNV-1a
+        size_t operator()(const MyCache::InlineString<N> &key) const
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            const unsigned char *bytes = reinterpret_cast<const unsigned char *>(key.data());
+            for (size_t i = 0; i < key.size(); i++)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+}
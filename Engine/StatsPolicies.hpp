@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MyCache
+{
+    // 不统计：所有回调都是空函数，编译后完全消失
+    struct NoStats
+    {
+        void onHit() {}
+        void onMiss() {}
+        void onEviction() {}
+    };
+
+    // 计数统计：在缓存锁内更新，读取时需保证没有并发写
+    struct CountingStats
+    {
+        void onHit() { hits++; }
+        void onMiss() { misses++; }
+        void onEviction() { evictions++; }
+
+        double hitRate() const
+        {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+        }
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "NodeLayout.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MyCache
+{
+    /* 基于epoch的内存回收：读者在访问共享节点前pin住当前epoch，写者把摘除的节点retire，
+       只有当所有仍在读的线程pin住的epoch都大于节点retire时的epoch，节点才真正释放。
+       - 读者只写自己独占的一条记录(一次seq_cst存储)，从不阻塞；
+       - 线程数超过kMaxThreads时退化为共享的计数器，此时有这类读者在读就不释放任何节点。 */
+    class EpochReclaimer
+    {
+    public:
+        static constexpr size_t kMaxThreads = 256;
+
+        // 读者的作用域守卫，析构时退出临界区；可嵌套
+        class Guard
+        {
+        public:
+            explicit Guard(EpochReclaimer &reclaimer) : reclaimer_(&reclaimer), index_(threadIndex())
+            {
+                reclaimer_->enter(index_);
+            }
+
+            ~Guard()
+            {
+                if (reclaimer_)
+                    reclaimer_->leave(index_);
+            }
+
+            Guard(Guard &&other) : reclaimer_(other.reclaimer_), index_(other.index_) { other.reclaimer_ = nullptr; }
+            Guard(const Guard &) = delete;
+            Guard &operator=(const Guard &) = delete;
+
+        private:
+            EpochReclaimer *reclaimer_;
+            size_t index_;
+        };
+
+        EpochReclaimer() : epoch_(1), overflowActive_(0), records_(kMaxThreads) {}
+
+        ~EpochReclaimer()
+        {
+            // 析构时已没有读者
+            for (auto &retired : retired_)
+                retired.deleter(retired.ptr);
+        }
+
+        EpochReclaimer(const EpochReclaimer &) = delete;
+        EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+
+        Guard pin() { return Guard(*this); }
+
+        // 节点已从所有共享结构中摘除后调用，之后的新读者不可能再看到它
+        template <typename T>
+        void retire(T *ptr)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retired_.push_back({ptr, [](void *p)
+                                { delete static_cast<T *>(p); },
+                                epoch_.load()});
+            if (retired_.size() >= collectThreshold_)
+                collectLocked();
+        }
+
+        // 推进epoch并释放所有读者都已越过的节点
+        void collect()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            collectLocked();
+        }
+
+        size_t pendingCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return retired_.size();
+        }
+
+    private:
+        struct alignas(kCacheLineSize) Record
+        {
+            std::atomic<uint64_t> epoch{0}; // 0表示不在临界区
+            int depth = 0;                  // 只由所属线程读写
+        };
+
+        struct Retired
+        {
+            void *ptr;
+            void (*deleter)(void *);
+            uint64_t epoch;
+        };
+
+        // 进程内的线程编号，线程退出后编号回收复用
+        static size_t threadIndex()
+        {
+            struct Registration
+            {
+                size_t index;
+                Registration() : index(acquireIndex()) {}
+                ~Registration() { releaseIndex(index); }
+            };
+            thread_local Registration registration;
+            return registration.index;
+        }
+
+        static std::mutex &registryMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        static std::vector<size_t> &freeIndices()
+        {
+            static std::vector<size_t> indices;
+            return indices;
+        }
+
+        static size_t acquireIndex()
+        {
+            static size_t next = 0;
+            std::lock_guard<std::mutex> lock(registryMutex());
+            if (!freeIndices().empty())
+            {
+                size_t index = freeIndices().back();
+                freeIndices().pop_back();
+                return index;
+            }
+            return next++;
+        }
+
+        static void releaseIndex(size_t index)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            freeIndices().push_back(index);
+        }
+
+        void enter(size_t index)
+        {
+            if (index >= kMaxThreads)
+            {
+                overflowActive_.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return;
+            }
+            Record &record = records_[index];
+            if (record.depth++ == 0)
+            {
+                record.epoch.store(epoch_.load());
+                // 之后对共享结构的读取不会早于这次存储，与collect中的栅栏配对
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        void leave(size_t index)
+        {
+            if (index >= kMaxThreads)
+            {
+                overflowActive_.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            Record &record = records_[index];
+            if (--record.depth == 0)
+                record.epoch.store(0, std::memory_order_release);
+        }
+
+        void collectLocked()
+        {
+            epoch_.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // 摘除节点的写入先于下面对读者记录的读取
+            if (overflowActive_.load() > 0)
+                return;
+            uint64_t minEpoch = UINT64_MAX;
+            for (size_t i = 0; i < kMaxThreads; i++)
+            {
+                uint64_t epoch = records_[i].epoch.load();
+                if (epoch != 0 && epoch < minEpoch)
+                    minEpoch = epoch;
+            }
+            size_t kept = 0;
+            for (size_t i = 0; i < retired_.size(); i++)
+            {
+                if (retired_[i].epoch < minEpoch)
+                    retired_[i].deleter(retired_[i].ptr);
+                else
+                    retired_[kept++] = retired_[i];
+            }
+            retired_.resize(kept);
+            // 读者长时间不退出时避免每次retire都扫描
+            collectThreshold_ = std::max<size_t>(64, kept * 2);
+        }
+
+        std::atomic<uint64_t> epoch_;
+        std::atomic<int> overflowActive_; // 超出kMaxThreads的线程共用的计数
+        std::vector<Record, CacheLineAllocator<Record>> records_;
+        std::mutex mutex_; // 保护retired_
+        std::vector<Retired> retired_;
+        size_t collectThreshold_ = 64;
+    };
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MyCache
+{
+    /* GDSF(Greedy-Dual-Size-Frequency)：按大小和未命中代价淘汰，适合value大小、加载代价差异很大的场景。
+       优先级H = L + 访问次数 * 代价 / 大小，淘汰H最小的条目，L(膨胀时钟)取最近一次被淘汰条目的H。
+       新条目的H以当前的L为起点，长期不被访问的条目会被新条目超过，相当于按时间老化。
+       容量按size累计，单位由调用方决定(字节、KB等)；put(key, value)按大小1、代价1处理。
+       优先级保存在带下标的二叉堆中，访问和淘汰都是O(log n)。大于总容量的条目不会被缓存。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class GdsfCache : public CachePolicy<Key, Value>
+    {
+    public:
+        explicit GdsfCache(size_t capacity) : capacity_(capacity), used_(0), inflation_(0.0)
+        {
+        }
+
+        ~GdsfCache() override
+        {
+            for (Node *node : heap_)
+                delete node;
+        }
+
+        void put(Key key, Value value) override
+        {
+            put(std::move(key), std::move(value), 1, 1.0);
+        }
+
+        // size为条目占用的容量，cost为未命中时重新加载的代价(如毫秒)
+        void put(Key key, Value value, size_t size, double cost)
+        {
+            if (size == 0)
+                size = 1;
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (size > capacity_)
+            {
+                // 放不下的条目不缓存，同时丢掉旧值，避免读到过期数据
+                if (it != nodeMap_.end())
+                    removeNode(it->second);
+                return;
+            }
+            Node *node;
+            if (it != nodeMap_.end())
+            {
+                node = it->second;
+                used_ -= node->size;
+                node->value = std::move(value);
+                node->frequency++;
+            }
+            else
+            {
+                node = new Node(key, std::move(value));
+                node->heapIndex = heap_.size();
+                heap_.push_back(node);
+                nodeMap_.emplace(std::move(key), node);
+            }
+            node->size = size;
+            node->cost = cost;
+            used_ += size;
+            updatePriority(node);
+            while (used_ > capacity_)
+                evict();
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end())
+                return false;
+            Node *node = it->second;
+            node->frequency++;
+            updatePriority(node);
+            value = node->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end())
+                removeNode(it->second);
+        }
+
+        size_t size()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return nodeMap_.size();
+        }
+
+        // 已用容量(各条目size之和)
+        size_t usedCapacity()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return used_;
+        }
+
+        // 当前的膨胀时钟L
+        double inflation()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return inflation_;
+        }
+
+    private:
+        struct Node
+        {
+            Node(const Key &key, Value value) : heapIndex(0), priority(0.0), frequency(1), size(1), cost(1.0), key(key), value(std::move(value)) {}
+
+            size_t heapIndex; // 在heap_中的下标
+            double priority;
+            uint64_t frequency;
+            size_t size;
+            double cost;
+            Key key;
+            Value value;
+        };
+
+        void updatePriority(Node *node)
+        {
+            node->priority = inflation_ + static_cast<double>(node->frequency) * node->cost / static_cast<double>(node->size);
+            // 已有节点的优先级只增不减，需要下沉；新节点在堆尾，需要上浮
+            siftUp(node->heapIndex);
+            siftDown(node->heapIndex);
+        }
+
+        void evict()
+        {
+            Node *victim = heap_.front();
+            inflation_ = victim->priority;
+            removeNode(victim);
+        }
+
+        void removeNode(Node *node)
+        {
+            size_t index = node->heapIndex;
+            Node *last = heap_.back();
+            heap_.pop_back();
+            if (last != node)
+            {
+                heap_[index] = last;
+                last->heapIndex = index;
+                siftUp(index);
+                siftDown(last->heapIndex);
+            }
+            used_ -= node->size;
+            nodeMap_.erase(node->key);
+            delete node;
+        }
+
+        void siftUp(size_t index)
+        {
+            Node *node = heap_[index];
+            while (index > 0)
+            {
+                size_t parent = (index - 1) / 2;
+                if (heap_[parent]->priority <= node->priority)
+                    break;
+                place(heap_[parent], index);
+                index = parent;
+            }
+            place(node, index);
+        }
+
+        void siftDown(size_t index)
+        {
+            Node *node = heap_[index];
+            size_t count = heap_.size();
+            while (true)
+            {
+                size_t child = index * 2 + 1;
+                if (child >= count)
+                    break;
+                if (child + 1 < count && heap_[child + 1]->priority < heap_[child]->priority)
+                    child++;
+                if (node->priority <= heap_[child]->priority)
+                    break;
+                place(heap_[child], index);
+                index = child;
+            }
+            place(node, index);
+        }
+
+        void place(Node *node, size_t index)
+        {
+            heap_[index] = node;
+            node->heapIndex = index;
+        }
+
+        size_t capacity_;
+        size_t used_;
+        double inflation_; // 膨胀时钟L
+        std::vector<Node *> heap_; // 按优先级的最小堆
+        std::unordered_map<Key, Node *> nodeMap_;
+        Lock mutex_;
+    };
+}
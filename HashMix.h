@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace MyCache
+{
+    // 64位混淆函数(splitmix64的终结步骤)，是uint64上的双射；一致性哈希、近端缓存条带和负载生成共用
+    inline uint64_t mixKey(uint64_t key)
+    {
+        key ^= key >> 30;
+        key *= 0xBF58476D1CE4E5B9ULL;
+        key ^= key >> 27;
+        key *= 0x94D049BB133111EBULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    // 64位FNV-1a字节哈希，结果只取决于字节内容
+    inline uint64_t fnv1a(const char *data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /* 与标准库实现无关的key哈希：std::hash的结果随标准库而变，不同客户端要把同一个key算到同一个值时用它。
+       整数直接混淆，字符串对字节做FNV-1a再混淆；其他key类型需要自行特化。 */
+    template <typename Key, typename Enable = void>
+    struct StableHash;
+
+    template <typename Key>
+    struct StableHash<Key, typename std::enable_if<std::is_integral<Key>::value>::type>
+    {
+        uint64_t operator()(Key key) const { return mixKey(static_cast<uint64_t>(key)); }
+    };
+
+    template <>
+    struct StableHash<std::string>
+    {
+        uint64_t operator()(const std::string &key) const { return mixKey(fnv1a(key.data(), key.size())); }
+    };
+}
@@ -1,112 +1,64 @@
 #pragma once
 
 #include "CachePolicy.h"
+#include "CacheLock.h"
+#include "Engine/EngineStore.hpp"
+#include "MaintenanceExecutor.hpp"
+#include "NumaArena.hpp"
+#include "NodeLayout.h"
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
+#include <climits>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
 
 namespace MyCache
 {
-    template <typename Key, typename Value>
-    class LfuCache;
-
-    template <typename Key, typename Value>
-    class FreqList
-    {
-    private:
-        struct Node
-        {
-            int freq; // 访问频次
-            Key key;
-            Value value;
-            std::weak_ptr<Node> pre; // 打破循环依赖
-            std::shared_ptr<Node> next;
-
-            Node() : freq(1), next(nullptr) {}
-            Node(Key key, Value value) : freq(1), key(key), value(value), next(nullptr) {}
-        };
-        using NodePtr = std::shared_ptr<Node>;
-        std::shared_ptr<Node> head_;
-        std::shared_ptr<Node> tail_;
-        int freq_; // 当前链表的频率是多少
-
-    public:
-        explicit FreqList(int freq) : freq_(freq)
-        {
-            head_ = std::make_shared<Node>();
-            tail_ = std::make_shared<Node>();
-            head_->next = tail_;
-            tail_->pre = head_;
-        }
-
-        bool isEmpty() const
-        {
-            return head_->next == tail_;
-        }
-
-        void addNode(NodePtr node)
-        {
-            if (!node || !head_ || !tail_)
-                return;
-            node->next = tail_;
-            auto pre = tail_->pre.lock();
-            node->pre = pre;
-            pre->next = node;
-            tail_->pre = node;
-        }
-
-        void removeNode(NodePtr node)
-        {
-            if (!node || !head_ || !tail_)
-                return;
-            if (!node->next || node->pre.expired())
-                return;
-            auto pre = node->pre.lock();
-            pre->next = node->next;
-            node->next->pre = pre;
-            node->next = nullptr;
-        }
-
-        NodePtr getFirstNode()
-        {
-            return head_->next;
-        }
-        friend class LfuCache<Key, Value>;
-    };
-    template <typename Key, typename Value>
+    /* Lock为NullLock时是不加锁的单线程版本，适合每个线程独占一个实例(见PerThreadCache)。
+       索引、频次桶和节点分配由EngineStore<HashIndex, LfuEviction>完成(与CacheEngine共用)：
+       频次桶按频次升序串起，最小频次就是第一个桶，访问和淘汰都是O(1)；
+       这里只负责加锁、平均频次老化、容量调整和遍历游标。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
     class LfuCache : public CachePolicy<Key, Value>
     {
     private:
-        using Node = typename FreqList<Key, Value>::Node;
-        using NodePtr = std::shared_ptr<Node>;
-        using NodeMap = std::unordered_map<Key, NodePtr>;
+        using Store = EngineStore<Key, Value, HashIndex, LfuEviction, CursorMark, NumaAllocator<char>>;
+        using Node = typename Store::Node;
+        using Bucket = typename Store::EvictionPolicy::BucketType;
 
-        std::unordered_map<int, FreqList<Key, Value> *> freqToFreqList_;
-        NodeMap nodeMap_;   // 全局找Node
+        std::shared_ptr<NumaArena> arena_; // 节点内存池，为空时按缓存行对齐从普通堆分配；在所有节点之后析构
+        Store store_;
         int capacity_;      // 容量
-        int minFreq_;       // 最小访问次数(O1存取的关键)
         int curAverageNum_; // 当前访问次数平均值
         int maxAverageNum_; // 最大容忍访问次数平均值
         int curTotalNum_;   // 当前总访问次数
-        std::mutex mutex_;  // 互斥锁
+        Lock mutex_;        // 互斥锁
+        bool agingScheduled_ = false;   // 是否已提交后台老化任务
+        bool shrinkScheduled_ = false;  // 是否已提交后台缩容任务
+        MaintenanceHandle maintenance_; // 最后析构，先等待后台任务结束
 
     public:
         ~LfuCache() override = default;
 
-        LfuCache(int capacity, int maxAverageNum = 1000000) : capacity_(capacity), maxAverageNum_(maxAverageNum), curAverageNum_(0), curTotalNum_(0), minFreq_(INT8_MAX)
+        LfuCache(int capacity, int maxAverageNum = 1000000) : capacity_(capacity), curAverageNum_(0), maxAverageNum_(maxAverageNum), curTotalNum_(0)
         {
         }
 
         void put(Key key, Value value) override
         {
-            if (capacity_ == 0)
+            std::lock_guard<Lock> lock(mutex_);
+            if (capacity_ <= 0)
                 return;
-            std::lock_guard<std::mutex> lock(mutex_);
 
-            if (nodeMap_.find(key) != nodeMap_.end())
+            Node *node = store_.find(key);
+            if (node)
             {
-                NodePtr node = nodeMap_.find(key)->second;
                 node->value = value;
                 getInternal(node, value);
                 return;
@@ -117,11 +69,11 @@ namespace MyCache
 
         bool get(Key key, Value &value) override
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if (it != nodeMap_.end())
+            std::lock_guard<Lock> lock(mutex_);
+            Node *node = store_.find(key);
+            if (node)
             {
-                getInternal(it->second, value);
+                getInternal(node, value);
                 return true;
             }
             return false;
@@ -134,176 +86,360 @@ namespace MyCache
             return value;
         }
 
-        // 清空
+        void remove(Key key)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            Node *node = store_.find(key);
+            if (!node)
+                return;
+            int freq = frequency(node);
+            store_.erase(node);
+            decreaseFreqNum(freq);
+        }
+
+        int getCapacity()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return capacity_;
+        }
+
+        /* 在线调整容量。扩容时按新容量预留哈希表的桶，之后填满的过程中不会再触发rehash；
+           缩容不在这里一次淘汰完：开启后台维护时由后台任务每次持锁淘汰kShrinkBatch个，
+           同时之后每次put最多顺带淘汰kShrinkBatch个，也可以调用evictExcess主动推进。 */
+        void setCapacity(int capacity)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            capacity_ = capacity;
+            if (capacity_ > 0)
+                store_.reserve(capacity_);
+            if (store_.size() > static_cast<size_t>(std::max(capacity_, 0)) && !shrinkScheduled_)
+                shrinkScheduled_ = maintenance_.trySchedule([this]()
+                                                            { shrinkInBackground(); });
+        }
+
+        // 淘汰最多maxCount个超出容量的节点，返回是否仍超出容量
+        bool evictExcess(size_t maxCount)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return evictBatch(maxCount);
+        }
+
+        // 设置后台维护线程池(需在并发访问前调用)，老化交给后台执行
+        void setMaintenanceExecutor(std::shared_ptr<MaintenanceExecutor> executor)
+        {
+            static_assert(!std::is_same<Lock, NullLock>::value, "后台维护需要真正的锁");
+            maintenance_.setExecutor(std::move(executor));
+        }
+
+        // 新节点从arena分配(需在插入前调用)，NUMA模式下arena绑定在分片所在的节点上
+        void setNodeArena(std::shared_ptr<NumaArena> arena)
+        {
+            arena_ = std::move(arena);
+            store_.setAllocator(NumaAllocator<char>(arena_.get()));
+        }
+
+        /* 弱一致的分块遍历，按频次从高到低，同一频次内从后进入的到先进入的(即淘汰顺序的逆序)：
+           游标是挂在频次桶里的哨兵节点(CursorMark)，每次next只在锁内走maxCount个节点，之后把游标挪到走过的位置并放锁。
+           被访问的节点移到更高频次桶的桶头，落在游标身后；新写入的节点进入频次1桶的桶头，游标还没走到频次1时会被返回。
+           因此遍历总会结束，遍历期间一直没被访问的key恰好返回一次，在游标到达之前被访问的key会漏掉；
+           老化会把节点挪回低频桶，遍历期间发生老化时可能重复返回一部分key。
+           遍历期间purge时，游标留在清空后的频次1桶里，之后的next直接结束；Scanner不能比缓存活得久。 */
+        class Scanner
+        {
+        public:
+            explicit Scanner(LfuCache &cache) : cache_(&cache), cursor_(nullptr)
+            {
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                Bucket *highest = cache_->store_.order().lowest();
+                if (!highest)
+                    return;
+                while (highest->next)
+                    highest = highest->next;
+                cursor_ = cache_->store_.create(Key(), Value());
+                cursor_->cursor = true;
+                cache_->store_.order().insertAfter(highest, nullptr, cursor_);
+            }
+
+            Scanner(Scanner &&other) : cache_(other.cache_), cursor_(other.cursor_) { other.cursor_ = nullptr; }
+            Scanner &operator=(Scanner &&) = delete;
+
+            ~Scanner()
+            {
+                if (!cursor_)
+                    return;
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                release();
+            }
+
+            // 取下一块，遍历结束时返回false
+            bool next(std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+            {
+                chunk.clear();
+                if (!cursor_)
+                    return false;
+                maxCount = std::max<size_t>(maxCount, 1);
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                Bucket *bucket = cursor_->bucket;
+                Node *last = cursor_;
+                Node *node = cursor_->next;
+                // 换桶也算一步
+                for (size_t count = 0; count < maxCount; ++count)
+                {
+                    if (!node)
+                    {
+                        bucket = bucket->prev;
+                        if (!bucket)
+                        {
+                            release();
+                            return !chunk.empty();
+                        }
+                        last = nullptr;
+                        node = bucket->head;
+                        continue;
+                    }
+                    if (!node->cursor) // 跳过其他遍历的游标
+                        chunk.emplace_back(node->key, node->value);
+                    last = node;
+                    node = node->next;
+                }
+                // 游标所在的桶只剩游标时随之回收，bucket是还有节点的桶(或就是游标所在的桶，last在其中)
+                cache_->store_.order().onRemove(cursor_);
+                cache_->store_.order().insertAfter(bucket, last, cursor_);
+                return true;
+            }
+
+        private:
+            void release()
+            {
+                cache_->store_.order().onRemove(cursor_);
+                cache_->store_.destroy(cursor_);
+                cursor_ = nullptr;
+            }
+
+            LfuCache *cache_;
+            Node *cursor_; // 为空表示遍历结束
+        };
+
+        Scanner scan() { return Scanner(*this); }
+
+        // 清空；正在进行的遍历的游标不释放，重新挂到空的淘汰顺序里
         void purge()
         {
-            nodeMap_.clear();
-            freqToFreqList_.clear();
+            std::lock_guard<Lock> lock(mutex_);
+            std::vector<Node *> cursors;
+            while (Node *node = store_.order().victim())
+            {
+                if (node->cursor)
+                {
+                    store_.order().onRemove(node);
+                    cursors.push_back(node);
+                }
+                else
+                {
+                    store_.erase(node);
+                }
+            }
+            for (Node *cursor : cursors)
+                store_.order().onInsert(cursor);
+            curTotalNum_ = 0;
+            curAverageNum_ = 0;
         }
 
     private:
-        void getInternal(NodePtr node, Value &value); // 获取缓存，并且freq+1
-        void putInternal(Key key, Value value);       // 放置缓存，并且freq+1
-
-        void kickOut(); // 移除第一个
+        void getInternal(Node *node, Value &value); // 获取缓存，并且freq+1
+        void putInternal(Key key, Value value);     // 放置缓存，并且freq+1
 
-        void removeFromFreqList(NodePtr node); // 从频率列表中移除节点
-        void addToFreqList(NodePtr node);      // 添加到频率列表
+        void kickOut(); // 移除最小频次中最早进入的节点
 
         void addFreqNum();              // 总访问频次++
         void decreaseFreqNum(int num);  // 减少总访问频次
         void handleOverMaxAverageNum(); // 解决平均频率太高
-        void updateMinFreq();           // 更新最小的频率
+        void scheduleAging();           // 提交老化任务，必要时同步执行
+        bool evictBatch(size_t maxCount); // 淘汰最多maxCount个超出容量的节点，返回是否仍超出
+        void shrinkInBackground();      // 后台缩容，每次持锁只淘汰一批
+
+        static int frequency(const Node *node) { return Store::EvictionPolicy::frequency(node); }
+
+        static const int kShrinkBatch = 64; // 缩容时每次持锁最多淘汰的节点数
     };
 
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::getInternal(NodePtr node, Value &value)
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::getInternal(Node *node, Value &value)
     {
-        // 找到之后需要将其从低访问频次的链表中删除，并且添加到+1的访问频次链表中，
-        // 访问频次+1, 然后把value值返回
+        // 移到频次+1的桶，然后把value值返回；最小频次桶被取空时随之回收
         value = node->value;
-        // 从原来的链表中删除
-        removeFromFreqList(node);
-        node->freq++;
-        addToFreqList(node);
-        // 如果当前node的访问频次如果等于minFreq+1，并且其前驱链表为空，则说明
-        // freqToFreqList_[node->freq - 1]链表因node的迁移已经空了，需要更新最小访问频次
-        if (node->freq - 1 == minFreq_ && freqToFreqList_[minFreq_]->isEmpty())
-            minFreq_++;
+        store_.access(node);
         // 总访问频次和当前平均访问频次都随之增加
         addFreqNum();
     }
 
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::putInternal(Key key, Value value)
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::putInternal(Key key, Value value)
     {
         // 如果不在缓存中，则需要判断缓存是否已满
-        if (nodeMap_.size() == capacity_)
+        if (store_.size() >= capacity_)
         {
-            // 缓存已满，删除最不常访问的结点，更新当前平均访问频次和总访问频次
-            kickOut();
+            // 缓存已满，删除最不常访问的结点，更新当前平均访问频次和总访问频次；
+            // 缩容后超出的部分每次put顺带多淘汰几个，逐步降到新容量
+            for (int n = 0; n < kShrinkBatch && store_.size() >= capacity_; ++n)
+                kickOut();
         }
-        NodePtr node = std::make_shared<Node>(key, value);
-        addToFreqList(node);
-        nodeMap_[key] = node;
+        store_.insert(key, value);
         addFreqNum();
-        minFreq_ = std::min(minFreq_, 1);
     }
 
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::removeFromFreqList(NodePtr node)
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::kickOut()
     {
-        if (!node)
-            return;
-        auto freq = node->freq;
-        freqToFreqList_[freq]->removeNode(node);
-    }
-
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::addToFreqList(NodePtr node)
-    {
-        if (!node)
-            return;
-        auto freq = node->freq;
-        if (freqToFreqList_.find(freq) == freqToFreqList_.end()) // 不存在
+        // 跳过遍历游标；只剩游标的桶不会被回收，需要往高频次找
+        for (Bucket *bucket = store_.order().lowest(); bucket; bucket = bucket->next)
         {
-            freqToFreqList_[freq] = new FreqList<Key, Value>(freq);
+            for (Node *node = bucket->tail; node; node = node->prev)
+            {
+                if (node->cursor)
+                    continue;
+                int freq = bucket->freq;
+                store_.erase(node);
+                decreaseFreqNum(freq);
+                return;
+            }
         }
-        freqToFreqList_[freq]->addNode(node);
-    }
-
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::kickOut()
-    {
-        NodePtr node = freqToFreqList_[minFreq_]->getFirstNode();
-        removeFromFreqList(node);
-        nodeMap_.erase(node->key);
-        decreaseFreqNum(node->freq);
     }
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::addFreqNum()
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::addFreqNum()
     {
         curTotalNum_++;
-        if (nodeMap_.empty())
+        if (store_.size() == 0)
             curAverageNum_ = 0;
         else
-            curAverageNum_ = std::ceil(curTotalNum_ / nodeMap_.size());
+            curAverageNum_ = std::ceil(curTotalNum_ / store_.size());
         if (curAverageNum_ > maxAverageNum_)
-            handleOverMaxAverageNum();
+            scheduleAging();
     }
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::decreaseFreqNum(int num)
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::decreaseFreqNum(int num)
     {
         curTotalNum_ -= num;
-        if (nodeMap_.empty())
+        if (store_.size() == 0)
             curAverageNum_ = 0;
         else
-            curAverageNum_ = curTotalNum_ / nodeMap_.size();
+            curAverageNum_ = curTotalNum_ / store_.size();
     }
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::handleOverMaxAverageNum()
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::handleOverMaxAverageNum()
     {
-        if (nodeMap_.size() == 0)
+        if (store_.size() == 0)
             return;
-        for (auto it = nodeMap_.begin(); it != nodeMap_.end(); it++)
+        // 所有节点的频次减去maxAverageNum_/2(最小为1)，只改桶上的频次，降到1的桶合并
+        store_.order().age(maxAverageNum_ / 2);
+        // 重新统计总访问频次，否则平均值一直超限，每次访问都会触发老化
+        curTotalNum_ = 0;
+        for (Bucket *bucket = store_.order().lowest(); bucket; bucket = bucket->next)
         {
-            if (!it->second)
-                continue;
-            NodePtr node = it->second;
-
-            // 先去除node
-            removeFromFreqList(node);
-
-            // 减去freq
-            node->freq -= maxAverageNum_ / 2;
-            if (node->freq < 1)
-                node->freq = 1;
-            // 再加回去
-            addToFreqList(node);
+            for (Node *node = bucket->head; node; node = node->next)
+            {
+                if (!node->cursor)
+                    curTotalNum_ += bucket->freq;
+            }
         }
-        updateMinFreq();
+        curAverageNum_ = curTotalNum_ / store_.size();
     }
 
-    template <typename Key, typename Value>
-    void LfuCache<Key, Value>::updateMinFreq()
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::scheduleAging()
     {
-        minFreq_ = INT8_MAX;
-        for (const auto &pair : freqToFreqList_)
+        // 维护落后(平均频次达到上限两倍)或提交被拒绝时在本线程同步老化
+        if (maintenance_.enabled() && curAverageNum_ / 2 < maxAverageNum_)
         {
-            if (pair.second && !pair.second->isEmpty())
-                minFreq_ = std::min(minFreq_, pair.first);
+            if (agingScheduled_)
+                return;
+            agingScheduled_ = maintenance_.trySchedule([this]()
+                                                       {
+                std::lock_guard<Lock> lock(mutex_);
+                agingScheduled_ = false;
+                if (curAverageNum_ > maxAverageNum_)
+                    handleOverMaxAverageNum(); });
+            if (agingScheduled_)
+                return;
         }
-        if (minFreq_ == INT8_MAX)
-            minFreq_ = 1;
+        handleOverMaxAverageNum();
+    }
+
+    template <typename Key, typename Value, typename Lock>
+    bool LfuCache<Key, Value, Lock>::evictBatch(size_t maxCount)
+    {
+        size_t limit = static_cast<size_t>(std::max(capacity_, 0));
+        for (size_t n = 0; n < maxCount && store_.size() > limit; ++n)
+            kickOut();
+        return store_.size() > limit;
+    }
+
+    template <typename Key, typename Value, typename Lock>
+    void LfuCache<Key, Value, Lock>::shrinkInBackground()
+    {
+        std::lock_guard<Lock> lock(mutex_);
+        shrinkScheduled_ = false;
+        if (evictBatch(kShrinkBatch))
+            shrinkScheduled_ = maintenance_.trySchedule([this]()
+                                                        { shrinkInBackground(); });
     }
 
+    /* 分片LFU：
+       - 容量再平衡：统计每个分片的未命中次数，rebalance()把容量从未命中少的分片逐步挪给未命中多的分片，
+         每次只锁一个分片，总容量保持不变；
+       - 分片增长(可选)：setMaxSliceNum()后，按线性哈希的方式一次分裂一个分片以缓解锁争用，
+         旧分片中的数据不整体搬迁，而是在新分片未命中时惰性迁移。 */
     template <typename Key, typename Value>
     class HashLfuCache
     {
     public:
-        HashLfuCache(int capacity, int sliceNum, int maxAverageNum = 10) : capacity_(capacity), sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+        // executor不为空时，所有分片共享该后台维护线程池
+        HashLfuCache(int capacity, int sliceNum, int maxAverageNum = 10, std::shared_ptr<MaintenanceExecutor> executor = nullptr)
+            : capacity_(capacity), sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()),
+              maxSliceNum_(sliceNum_), maxAverageNum_(maxAverageNum), activeSliceNum_(sliceNum_), autoRebalanceInterval_(0),
+              rebalanceScheduled_(false), executor_(executor)
         {
+            maintenance_.setExecutor(executor_);
             int sliceSize=std::ceil(capacity_/static_cast<double>(sliceNum_));
             for(int i=0;i<sliceNum_;i++)
-            {
-                lfuSliceCaches_.emplace_back(new LfuCache<Key,Value>(sliceSize,maxAverageNum));
-            }
+                addSlice(sliceSize);
+            stats_ = StatsArray(maxSliceNum_);
         }
         void put(Key key,Value value)
         {
-             // 根据key找出对应的lfu分片
-             size_t sliceIndex=Hash(key)%sliceNum_;
-             lfuSliceCaches_[sliceIndex]->put(key,value);
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            putToSlice(key, value, activeNum);
+            // 期间发生了分裂，按新的映射重新写一次，保证不会留下旧值
+            int currentNum = activeSliceNum_.load(std::memory_order_acquire);
+            if (currentNum != activeNum)
+                putToSlice(key, value, currentNum);
+            countOperation();
         }
         bool get(Key key, Value &value)
         {
             // 根据key找出对应的lfu分片
-            size_t sliceIndex = Hash(key) % sliceNum_;
-            return lfuSliceCaches_[sliceIndex]->get(key, value);
+            size_t hashValue = Hash(key);
+            int sliceIndex = getSliceIndex(hashValue, activeSliceNum_.load(std::memory_order_acquire));
+            SliceStats &stats = stats_[sliceIndex];
+            bool trackContention = maxSliceNum_ > sliceNum_;
+            if (trackContention && stats.inFlight.fetch_add(1, std::memory_order_relaxed) > 0)
+                stats.contended.fetch_add(1, std::memory_order_relaxed);
+
+            bool hit = lfuSliceCaches_[sliceIndex]->get(key, value);
+            if (!hit && sliceIndex >= sliceNum_)
+                hit = migrateFromParents(key, value, sliceIndex);
+
+            if (trackContention)
+                stats.inFlight.fetch_sub(1, std::memory_order_relaxed);
+            stats.accesses.fetch_add(1, std::memory_order_relaxed);
+            if (!hit)
+                stats.misses.fetch_add(1, std::memory_order_relaxed);
+            countOperation();
+            return hit;
         }
         Value get(Key key)
         {
-            Value value;
+            Value value{};
             get(key, value);
             return value;
         }
@@ -312,16 +448,332 @@ namespace MyCache
             for (auto &lfuSliceCache : lfuSliceCaches_)
                 lfuSliceCache->purge();
         }
+
+        int getCapacity()
+        {
+            std::lock_guard<std::mutex> lock(rebalanceMutex_);
+            return capacity_;
+        }
+
+        /* 在线调整总容量：各分片按当前容量等比例缩放，保留再平衡得到的分布；
+           先缩容的分片后扩容的分片，每个分片只在自己的锁内调整，缩容逐步进行(见LfuCache::setCapacity)。 */
+        void setCapacity(int capacity)
+        {
+            std::lock_guard<std::mutex> lock(rebalanceMutex_);
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            std::vector<int> oldCapacities(activeNum), newCapacities(activeNum);
+            long long oldTotal = 0;
+            for (int i = 0; i < activeNum; i++)
+            {
+                oldCapacities[i] = lfuSliceCaches_[i]->getCapacity();
+                oldTotal += oldCapacities[i];
+            }
+            capacity = std::max(capacity, 0);
+            int assigned = 0;
+            for (int i = 0; i < activeNum; i++)
+            {
+                newCapacities[i] = oldTotal > 0 ? static_cast<int>(oldCapacities[i] * static_cast<long long>(capacity) / oldTotal)
+                                                : capacity / activeNum;
+                assigned += newCapacities[i];
+            }
+            for (int i = 0; assigned < capacity; i = (i + 1) % activeNum, assigned++)
+                newCapacities[i]++; // 取整剩下的零头
+            for (int shrink = 1; shrink >= 0; shrink--)
+            {
+                for (int i = 0; i < activeNum; i++)
+                {
+                    if ((newCapacities[i] < oldCapacities[i]) == (shrink == 1))
+                        lfuSliceCaches_[i]->setCapacity(newCapacities[i]);
+                }
+            }
+            capacity_ = capacity;
+        }
+
+        // 每个分片淘汰最多maxCount个超出容量的节点，返回是否仍有分片超出容量
+        bool evictExcess(size_t maxCount)
+        {
+            bool remaining = false;
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            for (int i = 0; i < activeNum; i++)
+                remaining = lfuSliceCaches_[i]->evictExcess(maxCount) || remaining;
+            return remaining;
+        }
+
+        /* 逐个分片遍历，每个分片内的语义同LfuCache::Scanner，同一时刻只在一个分片里挂游标。
+           分裂出的分片编号总比祖先大，遍历期间迁移的key从已遍历的祖先挪到后面的分片，只会重复不会漏掉。 */
+        class Scanner
+        {
+        public:
+            explicit Scanner(HashLfuCache &cache) : cache_(&cache), slice_(0) {}
+
+            bool next(std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+            {
+                while (slice_ < cache_->activeSliceNum_.load(std::memory_order_acquire))
+                {
+                    if (!current_)
+                        current_.reset(new SliceScanner(*cache_->lfuSliceCaches_[slice_]));
+                    if (current_->next(chunk, maxCount))
+                        return true;
+                    current_.reset();
+                    slice_++;
+                }
+                chunk.clear();
+                return false;
+            }
+
+        private:
+            using SliceScanner = typename LfuCache<Key, Value>::Scanner;
+            HashLfuCache *cache_;
+            int slice_;
+            std::unique_ptr<SliceScanner> current_;
+        };
+
+        Scanner scan() { return Scanner(*this); }
+
+        void remove(Key key)
+        {
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            removeFromSlice(key, activeNum);
+            // 与put相同，期间发生了分裂就按新的映射再删一次
+            int currentNum = activeSliceNum_.load(std::memory_order_acquire);
+            if (currentNum != activeNum)
+                removeFromSlice(key, currentNum);
+        }
+
+        // 允许分片数量增长到maxSliceNum(需在并发访问前调用)
+        void setMaxSliceNum(int maxSliceNum)
+        {
+            if (maxSliceNum <= maxSliceNum_)
+                return;
+            for (int i = maxSliceNum_; i < maxSliceNum; i++)
+                addSlice(0);
+            maxSliceNum_ = maxSliceNum;
+            stats_ = StatsArray(maxSliceNum_);
+            migrateMutexes_.reset(new std::mutex[maxSliceNum_]);
+        }
+
+        // 开启NUMA模式(需在使用前调用，已有数据会被丢弃)：分片轮流放到各节点上，分片对象和缓存节点从所在节点的内存池分配
+        void setNumaTopology(std::shared_ptr<const NumaTopology> topology)
+        {
+            std::vector<int> capacities;
+            for (auto &lfuSliceCache : lfuSliceCaches_)
+                capacities.push_back(lfuSliceCache->getCapacity());
+            lfuSliceCaches_.clear(); // 旧分片可能在旧的内存池上，先于内存池释放
+            topology_ = std::move(topology);
+            arenas_.clear();
+            for (int node = 0; node < topology_->nodeCount(); node++)
+                arenas_.push_back(std::make_shared<NumaArena>(topology_, node));
+            for (int capacity : capacities)
+                addSlice(capacity);
+        }
+
+        // 每interval次操作自动执行一次rebalance()，有维护线程池时交给后台，0表示关闭
+        void setAutoRebalanceInterval(uint64_t interval)
+        {
+            autoRebalanceInterval_ = interval;
+        }
+
+        int getSliceNum() const { return activeSliceNum_.load(std::memory_order_acquire); }
+
+        int getSliceCapacity(int sliceIndex) { return lfuSliceCaches_[sliceIndex]->getCapacity(); }
+
+        /* 根据上一周期各分片的未命中次数调整容量：未命中最多的分片向未命中最少的分片借容量，
+           依次配对，每对每次最多挪动供出方容量的1/8。争用比例过高时再分裂一个分片。 */
+        void rebalance()
+        {
+            std::lock_guard<std::mutex> lock(rebalanceMutex_);
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            std::vector<std::pair<uint64_t, int>> pressure; // (未命中次数, 分片下标)
+            uint64_t totalAccesses = 0, totalContended = 0;
+            for (int i = 0; i < activeNum; i++)
+            {
+                pressure.emplace_back(stats_[i].misses.exchange(0, std::memory_order_relaxed), i);
+                totalAccesses += stats_[i].accesses.exchange(0, std::memory_order_relaxed);
+                totalContended += stats_[i].contended.exchange(0, std::memory_order_relaxed);
+            }
+            std::sort(pressure.begin(), pressure.end());
+
+            int minSliceCapacity = std::max(1, capacity_ / (activeNum * 4));
+            for (int i = 0, j = activeNum - 1; i < j; i++, j--)
+            {
+                uint64_t donorMisses = pressure[i].first;
+                uint64_t receiverMisses = pressure[j].first;
+                // 差距不明显时不调整，避免来回抖动
+                if (receiverMisses * 4 <= donorMisses * 5)
+                    break;
+                LfuCache<Key, Value> &donor = *lfuSliceCaches_[pressure[i].second];
+                LfuCache<Key, Value> &receiver = *lfuSliceCaches_[pressure[j].second];
+                int donorCapacity = donor.getCapacity();
+                int step = std::min(std::max(1, donorCapacity / 8), donorCapacity - minSliceCapacity);
+                if (step <= 0)
+                    continue;
+                // 先缩容再扩容，任一时刻总容量都不超过上限
+                donor.setCapacity(donorCapacity - step);
+                receiver.setCapacity(receiver.getCapacity() + step);
+            }
+
+            if (activeNum < maxSliceNum_ && totalAccesses > 0 && totalContended * 10 > totalAccesses)
+                splitSlice(activeNum);
+        }
+
+        // 手动分裂出一个分片，已达到最大分片数量时返回false
+        bool grow()
+        {
+            std::lock_guard<std::mutex> lock(rebalanceMutex_);
+            int activeNum = activeSliceNum_.load(std::memory_order_acquire);
+            if (activeNum >= maxSliceNum_)
+                return false;
+            splitSlice(activeNum);
+            return true;
+        }
+
     private:
+        struct alignas(kCacheLineSize) SliceStats
+        {
+            std::atomic<uint64_t> accesses{0};
+            std::atomic<uint64_t> misses{0};
+            std::atomic<uint64_t> contended{0}; // 进入时已有其他线程在访问该分片的次数
+            std::atomic<int> inFlight{0};
+        };
+        using StatsArray = std::vector<SliceStats, CacheLineAllocator<SliceStats>>;
+
         size_t Hash(Key key)
         {
             std::hash<Key> hashFunc;
             return hashFunc(key);
         }
 
+        void addSlice(int sliceSize)
+        {
+            std::shared_ptr<NumaArena> arena = topology_ ? arenas_[lfuSliceCaches_.size() % arenas_.size()] : nullptr;
+            lfuSliceCaches_.push_back(makeOnArena<LfuCache<Key, Value>>(arena.get(), sliceSize, maxAverageNum_));
+            if (arena)
+                lfuSliceCaches_.back()->setNodeArena(arena);
+            if (executor_)
+                lfuSliceCaches_.back()->setMaintenanceExecutor(executor_);
+        }
+
+        // 线性哈希：当前分裂轮次的起点为low，下标落在未分裂的区间时退回到上一轮的映射
+        int getSliceIndex(size_t hashValue, int activeNum) const
+        {
+            int low = sliceNum_;
+            while (low * 2 <= activeNum)
+                low *= 2;
+            size_t index = hashValue % (static_cast<size_t>(low) * 2);
+            if (index >= static_cast<size_t>(activeNum))
+                index = hashValue % low;
+            return static_cast<int>(index);
+        }
+
+        // 分裂产生的分片的父分片
+        int getParentIndex(int sliceIndex) const
+        {
+            int low = sliceNum_;
+            while (low * 2 <= sliceIndex)
+                low *= 2;
+            return sliceIndex - low;
+        }
+
+        // 分裂出的分片连同祖先分片中尚未迁移的旧值一起删除
+        void removeFromSlice(const Key &key, int activeNum)
+        {
+            int sliceIndex = getSliceIndex(Hash(key), activeNum);
+            if (sliceIndex < sliceNum_)
+            {
+                lfuSliceCaches_[sliceIndex]->remove(key);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(migrateMutexes_[sliceIndex]);
+            lfuSliceCaches_[sliceIndex]->remove(key);
+            for (int parent = getParentIndex(sliceIndex);; parent = getParentIndex(parent))
+            {
+                lfuSliceCaches_[parent]->remove(key);
+                if (parent < sliceNum_)
+                    break;
+            }
+        }
+        void putToSlice(const Key &key, const Value &value, int activeNum)
+        {
+            int sliceIndex = getSliceIndex(Hash(key), activeNum);
+            if (sliceIndex < sliceNum_)
+            {
+                lfuSliceCaches_[sliceIndex]->put(key, value);
+                return;
+            }
+            // 分裂出的分片：删掉祖先分片中尚未迁移的旧值，避免之后被当作命中返回
+            std::lock_guard<std::mutex> lock(migrateMutexes_[sliceIndex]);
+            for (int parent = getParentIndex(sliceIndex);; parent = getParentIndex(parent))
+            {
+                lfuSliceCaches_[parent]->remove(key);
+                if (parent < sliceNum_)
+                    break;
+            }
+            lfuSliceCaches_[sliceIndex]->put(key, value);
+        }
+
+        // 新分片未命中时到祖先分片中查找，找到则迁移过来
+        bool migrateFromParents(const Key &key, Value &value, int sliceIndex)
+        {
+            std::lock_guard<std::mutex> lock(migrateMutexes_[sliceIndex]);
+            if (lfuSliceCaches_[sliceIndex]->get(key, value))
+                return true;
+            for (int parent = getParentIndex(sliceIndex);; parent = getParentIndex(parent))
+            {
+                if (lfuSliceCaches_[parent]->get(key, value))
+                {
+                    lfuSliceCaches_[parent]->remove(key);
+                    lfuSliceCaches_[sliceIndex]->put(key, value);
+                    return true;
+                }
+                if (parent < sliceNum_)
+                    return false;
+            }
+        }
+
+        // 分裂第newIndex个分片：父分片让出一半容量，数据惰性迁移
+        void splitSlice(int newIndex)
+        {
+            LfuCache<Key, Value> &parent = *lfuSliceCaches_[getParentIndex(newIndex)];
+            int parentCapacity = parent.getCapacity();
+            parent.setCapacity(parentCapacity - parentCapacity / 2);
+            lfuSliceCaches_[newIndex]->setCapacity(parentCapacity / 2);
+            activeSliceNum_.store(newIndex + 1, std::memory_order_release);
+        }
+
+        void countOperation()
+        {
+            if (autoRebalanceInterval_ == 0)
+                return;
+            if (opCount_.fetch_add(1, std::memory_order_relaxed) % autoRebalanceInterval_ != autoRebalanceInterval_ - 1)
+                return;
+            if (rebalanceScheduled_.exchange(true))
+                return;
+            bool scheduled = maintenance_.trySchedule([this]()
+                                                      {
+                rebalance();
+                rebalanceScheduled_.store(false); });
+            if (!scheduled)
+            {
+                rebalance();
+                rebalanceScheduled_.store(false);
+            }
+        }
+
         int capacity_; // 容量
-        int sliceNum_; // 缓存分片数量
-        std::vector<std::unique_ptr<LfuCache<Key, Value>>> lfuSliceCaches_;
-        ; //// 缓存lfu分片容器
+        int sliceNum_; // 初始分片数量
+        int maxSliceNum_; // 允许增长到的最大分片数量
+        int maxAverageNum_;
+        std::atomic<int> activeSliceNum_; // 当前使用的分片数量
+        uint64_t autoRebalanceInterval_;
+        std::atomic<uint64_t> opCount_{0};
+        std::atomic<bool> rebalanceScheduled_;
+        std::shared_ptr<MaintenanceExecutor> executor_;
+        std::shared_ptr<const NumaTopology> topology_;    // 为空时不区分节点
+        std::vector<std::shared_ptr<NumaArena>> arenas_; // 每个节点一个内存池，在分片之后析构
+        std::vector<ArenaPtr<LfuCache<Key, Value>>> lfuSliceCaches_; // 缓存lfu分片容器(预先分配到maxSliceNum_)
+        StatsArray stats_;
+        std::unique_ptr<std::mutex[]> migrateMutexes_; // 分裂出的分片迁移数据时使用
+        std::mutex rebalanceMutex_;
+        MaintenanceHandle maintenance_; // 最后析构，先等待后台任务结束
     };
 }
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace MyCache
+{
+    /* LIRS：按重用距离(两次访问之间访问过的不同key数)而不是最近一次访问时间区分冷热。
+       - LIR块：重用距离小的块，常驻缓存，占容量的大部分；
+       - HIR块：其余的块，只有很小一部分(hirRatio)常驻，放在队列Q中按LRU淘汰；
+       - 栈S按最近访问排序，保存LIR块和最近访问过的HIR块(包括已被淘汰、只留元数据的非常驻块)，
+         栈底始终是LIR块(栈剪枝)。HIR块在栈中被再次访问说明重用距离小于最老的LIR块，二者交换身份。
+       循环范围超过容量时LRU全部未命中，而LIRS能让一部分块常驻。
+       非常驻HIR元数据最多保留capacity*nonResidentRatio个，超出时丢弃最早的。所有操作O(1)。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class LirsCache : public CachePolicy<Key, Value>
+    {
+    public:
+        LirsCache(int capacity, double hirRatio = 0.01, double nonResidentRatio = 2.0)
+            : capacity_(std::max(capacity, 0)), lirCount_(0), residentCount_(0), nonResidentCount_(0)
+        {
+            hirCapacity_ = std::min(capacity_, std::max(1, static_cast<int>(std::lround(capacity_ * hirRatio))));
+            lirCapacity_ = capacity_ - hirCapacity_;
+            maxNonResident_ = static_cast<size_t>(std::max(1.0, capacity_ * nonResidentRatio));
+        }
+
+        ~LirsCache() override
+        {
+            for (auto &item : nodeMap_)
+                delete item.second;
+        }
+
+        void put(Key key, Value value) override
+        {
+            if (capacity_ <= 0)
+                return;
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end() && it->second->state != NonResident)
+            {
+                it->second->value = value;
+                access(it->second);
+                return;
+            }
+            if (residentCount_ >= capacity_)
+                evictHir();
+
+            Node *node;
+            if (it == nodeMap_.end())
+            {
+                node = new Node(key);
+                nodeMap_.emplace(key, node);
+            }
+            else
+            {
+                node = it->second;
+                nonResident_.erase(node->qPos);
+                nonResidentCount_--;
+            }
+            node->value = value;
+            residentCount_++;
+
+            if (lirCount_ < lirCapacity_)
+            {
+                // 冷启动：LIR块未满时新块直接成为LIR
+                node->state = Lir;
+                lirCount_++;
+                pushStackTop(node);
+            }
+            else if (node->inStack && lirCapacity_ > 0)
+            {
+                // 非常驻块仍在栈中：重用距离小于栈底的LIR块，替换它
+                node->state = Lir;
+                lirCount_++;
+                pushStackTop(node);
+                demoteBottomLir();
+            }
+            else
+            {
+                node->state = HirResident;
+                pushStackTop(node);
+                pushQueueFront(node);
+            }
+            limitNonResident();
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end() || it->second->state == NonResident)
+                return false;
+            access(it->second);
+            value = it->second->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end())
+                return;
+            Node *node = it->second;
+            if (node->state == Lir)
+                lirCount_--;
+            if (node->state != NonResident)
+                residentCount_--;
+            if (node->state == NonResident)
+            {
+                nonResident_.erase(node->qPos);
+                nonResidentCount_--;
+            }
+            else if (node->state == HirResident)
+                queue_.erase(node->qPos);
+            if (node->inStack)
+                stack_.erase(node->sPos);
+            nodeMap_.erase(it);
+            delete node;
+            pruneStack();
+        }
+
+        // 常驻的key数
+        size_t size()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return residentCount_;
+        }
+
+    private:
+        enum State
+        {
+            Lir,
+            HirResident,
+            NonResident
+        };
+
+        struct Node;
+        using NodeList = std::list<Node *>;
+
+        struct Node
+        {
+            explicit Node(const Key &key) : state(HirResident), inStack(false), key(key) {}
+
+            State state;
+            bool inStack;
+            typename NodeList::iterator sPos; // 在栈S中的位置
+            typename NodeList::iterator qPos; // 常驻HIR时在队列Q中的位置，非常驻时在nonResident_中的位置
+            Key key;
+            Value value{};
+        };
+
+        // 命中常驻块
+        void access(Node *node)
+        {
+            if (node->state == Lir)
+            {
+                bool atBottom = node->sPos == std::prev(stack_.end());
+                pushStackTop(node);
+                if (atBottom)
+                    pruneStack();
+            }
+            else if (lirCount_ < lirCapacity_ || (node->inStack && lirCapacity_ > 0))
+            {
+                // LIR块未满(删除过LIR块)时直接升为LIR；
+                // 否则在栈中的HIR块被再次访问，升为LIR，栈底的LIR块降为HIR
+                queue_.erase(node->qPos);
+                node->state = Lir;
+                lirCount_++;
+                pushStackTop(node);
+                demoteBottomLir();
+            }
+            else
+            {
+                pushStackTop(node);
+                queue_.splice(queue_.begin(), queue_, node->qPos);
+            }
+        }
+
+        void pushStackTop(Node *node)
+        {
+            if (node->inStack)
+            {
+                stack_.splice(stack_.begin(), stack_, node->sPos);
+                return;
+            }
+            stack_.push_front(node);
+            node->sPos = stack_.begin();
+            node->inStack = true;
+        }
+
+        void pushQueueFront(Node *node)
+        {
+            queue_.push_front(node);
+            node->qPos = queue_.begin();
+        }
+
+        // LIR块超出lirCapacity_时把栈底的LIR块降为常驻HIR
+        void demoteBottomLir()
+        {
+            if (lirCount_ <= lirCapacity_)
+                return;
+            Node *bottom = stack_.back();
+            stack_.pop_back();
+            bottom->inStack = false;
+            bottom->state = HirResident;
+            lirCount_--;
+            pushQueueFront(bottom);
+            pruneStack();
+        }
+
+        // 弹出栈底的HIR块直到栈底是LIR块，非常驻块离开栈后不再有用，直接删除
+        void pruneStack()
+        {
+            while (!stack_.empty() && stack_.back()->state != Lir)
+            {
+                Node *bottom = stack_.back();
+                stack_.pop_back();
+                bottom->inStack = false;
+                if (bottom->state == NonResident)
+                    eraseNonResident(bottom);
+            }
+        }
+
+        // 淘汰队列Q中最久未访问的常驻HIR块，仍在栈中时保留为非常驻块
+        void evictHir()
+        {
+            if (queue_.empty())
+                return;
+            Node *victim = queue_.back();
+            queue_.pop_back();
+            residentCount_--;
+            if (!victim->inStack)
+            {
+                nodeMap_.erase(victim->key);
+                delete victim;
+                return;
+            }
+            victim->state = NonResident;
+            victim->value = Value{};
+            nonResident_.push_front(victim);
+            victim->qPos = nonResident_.begin();
+            nonResidentCount_++;
+        }
+
+        void limitNonResident()
+        {
+            while (nonResidentCount_ > maxNonResident_)
+            {
+                Node *oldest = nonResident_.back();
+                stack_.erase(oldest->sPos);
+                oldest->inStack = false;
+                eraseNonResident(oldest);
+            }
+        }
+
+        void eraseNonResident(Node *node)
+        {
+            nonResident_.erase(node->qPos);
+            nonResidentCount_--;
+            nodeMap_.erase(node->key);
+            delete node;
+        }
+
+        int capacity_;
+        int lirCapacity_;
+        int hirCapacity_;
+        int lirCount_;
+        int residentCount_;
+        size_t maxNonResident_;
+        size_t nonResidentCount_;
+        NodeList stack_;       // 栈S，表头为最近访问
+        NodeList queue_;       // 常驻HIR块，表尾最先淘汰
+        NodeList nonResident_; // 非常驻HIR块，表尾最早被淘汰
+        std::unordered_map<Key, Node *> nodeMap_;
+        Lock mutex_;
+    };
+}
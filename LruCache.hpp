@@ -1,82 +1,75 @@
 #pragma once
 
 #include "CachePolicy.h"
+#include "CacheLock.h"
+#include "Engine/EngineStore.hpp"
+#include "MaintenanceExecutor.hpp"
+#include "NumaArena.hpp"
+#include "NodeLayout.h"
+#include "ShardsTracker.hpp"
 #include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <vector>
 #include <thread>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
 // #include <iostream>
-#include <condition_variable>
 
 
 namespace MyCache
 {
-    template <typename Key, typename Value>
-    class LruCache;
-    template <typename Key, typename Value>
-    class LruNode
+    /* Lock为NullLock时是不加锁的单线程版本，适合每个线程独占一个实例(见PerThreadCache)。
+       索引、链表和节点分配由EngineStore<HashIndex, LruEviction>完成(与CacheEngine共用)，
+       这里只负责加锁、容量调整、后台淘汰和遍历游标。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class LruCache : public CachePolicy<Key, Value>
     {
     public:
-        std::condition_variable cd;
-        LruNode(Key key_, Value value_) : key_(key_), value_(value_), accessCount_(1) {};
-        Key getKey() const
-        {
-            return this->key_;
-        }
-        Value getValue() const
-        {
-            return this->value_;
-        }
-        size_t getAccessCount() const
+        using Store = EngineStore<Key, Value, HashIndex, LruEviction, CursorMark, NumaAllocator<char>>;
+        using Node = typename Store::Node;
+
+        ~LruCache() = default;
+
+        LruCache(int capacity_) : capacity_(capacity_), evictSlack_(0), evictScheduled_(false)
         {
-            return this->accessCount_;
         }
-        void setValue(Value value_)
+
+        // 设置后台维护线程池(需在并发访问前调用)：允许暂时超出容量evictSlack个节点，由后台批量淘汰
+        void setMaintenanceExecutor(std::shared_ptr<MaintenanceExecutor> executor, int evictSlack = 0)
         {
-            this->value_ = value_;
+            static_assert(!std::is_same<Lock, NullLock>::value, "后台维护需要真正的锁");
+            maintenance_.setExecutor(std::move(executor));
+            std::lock_guard<Lock> lock(mutex_);
+            evictSlack_ = evictSlack > 0 ? evictSlack : std::max(1, capacity_ / 16);
         }
-        // 返回递增后的值
-        int increasementAccessCount()
+
+        // 挂接未命中率曲线估计器(需在并发访问前调用)，每次get都会交给它采样
+        void setMissRatioTracker(std::shared_ptr<ShardsTracker<Key>> tracker)
         {
-            return ++this->accessCount_;
+            tracker_ = std::move(tracker);
         }
 
-    private:
-        std::weak_ptr<LruNode<Key, Value>> prev_; // 打破循环引用
-        std::shared_ptr<LruNode<Key, Value>> next_;
-        Key key_;
-        Value value_;
-        size_t accessCount_; // 访问次数
-        friend class LruCache<Key, Value>;
-    };
-
-    template <typename Key, typename Value>
-    class LruCache : public CachePolicy<Key, Value>
-    {
-    public:
-        using LruNodeType = LruNode<Key, Value>;
-        using NodePtr = std::shared_ptr<LruNodeType>;
-        using NodeMap = std::unordered_map<Key, NodePtr>;
-
-        ~LruCache() = default;
-
-        LruCache(int capacity_) : capacity_(capacity_)
+        // 新节点从arena分配(需在插入前调用)，NUMA模式下arena绑定在分片所在的节点上
+        void setNodeArena(std::shared_ptr<NumaArena> arena)
         {
-            init();
+            arena_ = std::move(arena);
+            store_.setAllocator(NumaAllocator<char>(arena_.get()));
         }
 
         void put(Key key, Value value) override
         {
+            // 上锁
+            std::lock_guard<Lock> lock(mutex_);
             if (this->capacity_ <= 0)
                 return;
-            // 上锁
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if (it != nodeMap_.end())
+            Node *node = store_.find(key);
+            if (node)
             {
-                updateExistingNode(it->second, value);
+                node->value = value;
+                store_.access(node);
                 return;
             }
             addNewNode(key, value);
@@ -84,13 +77,14 @@ namespace MyCache
 
         bool get(Key key, Value &value) override
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if (it == nodeMap_.end())
+            if (tracker_)
+                tracker_->record(key);
+            std::lock_guard<Lock> lock(mutex_);
+            Node *node = store_.find(key);
+            if (!node)
                 return false;
-            it->second->increasementAccessCount();
-            moveToMostRecent(it->second);
-            value = it->second->getValue();
+            store_.access(node);
+            value = node->value;
             return true;
         }
 
@@ -103,84 +97,175 @@ namespace MyCache
 
         void remove(Key key)
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = nodeMap_.find(key);
-            if (it == nodeMap_.end())
-                return;
-            removeNode(it->second);
-            nodeMap_.erase(it);
+            std::lock_guard<Lock> lock(mutex_);
+            Node *node = store_.find(key);
+            if (node)
+                store_.erase(node);
         }
 
-    private:
-        void init()
+        int getCapacity()
         {
-            dummyHead_ = std::make_shared<LruNodeType>(Key(), Value());
-            dummyTail_ = std::make_shared<LruNodeType>(Key(), Value());
-            dummyHead_->next_ = dummyTail_;
-            dummyTail_->prev_ = dummyHead_;
+            std::lock_guard<Lock> lock(mutex_);
+            return capacity_;
         }
-        void updateExistingNode(NodePtr node, const Value &value)
+
+        /* 在线调整容量。扩容时按新容量预留哈希表的桶，之后填满的过程中不会再触发rehash；
+           缩容不在这里一次淘汰完：开启后台维护时由后台任务每次持锁淘汰kShrinkBatch个，
+           同时之后每次put最多顺带淘汰kShrinkBatch个，也可以调用evictExcess主动推进。 */
+        void setCapacity(int capacity)
         {
-            node->setValue(value);
-            moveToMostRecent(node);
+            std::lock_guard<Lock> lock(mutex_);
+            capacity_ = capacity;
+            if (capacity_ > 0)
+                store_.reserve(capacity_);
+            if (store_.size() > static_cast<size_t>(std::max(capacity_, 0)) && !evictScheduled_)
+                evictScheduled_ = maintenance_.trySchedule([this]()
+                                                           { evictInBackground(); });
         }
-        void removeNode(NodePtr node)
+
+        // 淘汰最多maxCount个超出容量的节点，返回是否仍超出容量
+        bool evictExcess(size_t maxCount)
         {
-            if (!node->prev_.expired() && node->next_)
+            std::lock_guard<Lock> lock(mutex_);
+            return evictBatch(maxCount);
+        }
+
+        /* 弱一致的分块遍历，从最近访问到最久未访问：
+           游标是一个挂在链表里的哨兵节点(CursorMark)，每次next只在锁内走maxCount个节点，之后把游标挪到走过的位置并放锁。
+           被访问和新写入的节点都移到表头，落在游标身后，因此遍历总会结束，工作量不超过开始时的条目数，也不会重复返回；
+           遍历期间一直没被访问的key恰好返回一次，期间在游标到达之前被访问的key会漏掉，新写入的key不返回。
+           按返回顺序的逆序重新put即可恢复原来的最近访问顺序。Scanner不能比缓存活得久。 */
+        class Scanner
+        {
+        public:
+            explicit Scanner(LruCache &cache) : cache_(&cache), cursor_(nullptr)
+            {
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                cursor_ = cache_->store_.create(Key(), Value());
+                cursor_->cursor = true;
+                cache_->store_.order().insertAfter(nullptr, cursor_);
+            }
+
+            Scanner(Scanner &&other) : cache_(other.cache_), cursor_(other.cursor_) { other.cursor_ = nullptr; }
+            Scanner &operator=(Scanner &&) = delete;
+
+            ~Scanner()
+            {
+                if (!cursor_)
+                    return;
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                release();
+            }
+
+            // 取下一块，遍历结束时返回false
+            bool next(std::vector<std::pair<Key, Value>> &chunk, size_t maxCount)
+            {
+                chunk.clear();
+                if (!cursor_)
+                    return false;
+                maxCount = std::max<size_t>(maxCount, 1);
+                std::lock_guard<Lock> lock(cache_->mutex_);
+                Node *last = cursor_;
+                Node *node = cursor_->next;
+                for (size_t count = 0; node && count < maxCount; ++count)
+                {
+                    if (!node->cursor) // 跳过其他遍历的游标
+                        chunk.emplace_back(node->key, node->value);
+                    last = node;
+                    node = node->next;
+                }
+                if (!node)
+                {
+                    release();
+                    return !chunk.empty();
+                }
+                cache_->store_.order().onRemove(cursor_);
+                cache_->store_.order().insertAfter(last, cursor_);
+                return true;
+            }
+
+        private:
+            void release()
             {
-                auto prev_ = (node->prev_).lock();
-                auto next_ = node->next_;
-                prev_->next_ = next_;
-                next_->prev_ = prev_;
-                node->next_ = nullptr;
+                cache_->store_.order().onRemove(cursor_);
+                cache_->store_.destroy(cursor_);
+                cursor_ = nullptr;
             }
+
+            LruCache *cache_;
+            Node *cursor_; // 为空表示遍历结束
+        };
+
+        Scanner scan() { return Scanner(*this); }
+
+    private:
+        void addNewNode(const Key &key, const Value &value)
+        {
+            // 平时只淘汰一个；缩容后超出的部分每次put顺带多淘汰几个，逐步降到新容量
+            if (store_.size() >= capacity_ && !scheduleEviction())
+            {
+                for (int n = 0; n < kShrinkBatch && store_.size() >= capacity_; ++n)
+                    evictLeastRecent();
+            }
+            store_.insert(key, value);
         }
-        void moveToMostRecent(NodePtr node)
+        // 驱逐链表尾部最久未访问的节点
+        void evictLeastRecent()
         {
-            removeNode(node);
-            insertNode(node);
+            Node *leastRecent = store_.victim();
+            while (leastRecent && leastRecent->cursor) // 跳过遍历游标
+                leastRecent = leastRecent->prev;
+            if (leastRecent)
+                store_.erase(leastRecent);
         }
-        void insertNode(NodePtr node)
+        // 交给后台淘汰，超出容量达到evictSlack_(维护落后)或提交被拒绝时返回false，由调用线程同步淘汰
+        bool scheduleEviction()
         {
-            node->next_ = dummyTail_;
-            node->prev_ = dummyTail_->prev_;
-            dummyTail_->prev_.lock()->next_ = node;
-            dummyTail_->prev_ = node;
+            if (!maintenance_.enabled() || store_.size() >= capacity_ + evictSlack_)
+                return false;
+            if (evictScheduled_)
+                return true;
+            evictScheduled_ = maintenance_.trySchedule([this]()
+                                                       { evictInBackground(); });
+            return evictScheduled_;
         }
-        void addNewNode(const Key &key, const Value &value)
+        // 每次持锁只淘汰一批，还超出容量就重新提交，缩容时不会长时间占着锁
+        void evictInBackground()
         {
-            if (nodeMap_.size() >= capacity_)
-                evictLeastRecent();
-            NodePtr newNode = std::make_shared<LruNodeType>(key, value);
-            insertNode(newNode);
-            nodeMap_[key] = newNode;
+            std::lock_guard<Lock> lock(mutex_);
+            evictScheduled_ = false;
+            if (evictBatch(kShrinkBatch))
+                evictScheduled_ = maintenance_.trySchedule([this]()
+                                                           { evictInBackground(); });
         }
-        // 驱逐链表表头
-        void evictLeastRecent()
+        bool evictBatch(size_t maxCount)
         {
-            NodePtr leastRecent = dummyHead_->next_;
-            removeNode(leastRecent);
-            nodeMap_.erase(leastRecent->getKey());
+            size_t limit = static_cast<size_t>(std::max(capacity_, 0));
+            for (size_t n = 0; n < maxCount && store_.size() > limit; ++n)
+                evictLeastRecent();
+            return store_.size() > limit;
         }
+        static const int kShrinkBatch = 64; // 缩容时每次持锁最多淘汰的节点数
+        std::shared_ptr<NumaArena> arena_; // 节点内存池，为空时按缓存行对齐从普通堆分配；在所有节点之后析构
         int capacity_;
-        NodeMap nodeMap_;
-        std::mutex mutex_;
-        // 虚拟头节点
-        NodePtr dummyHead_;
-        // 虚拟尾节点
-        NodePtr dummyTail_;
+        Store store_;
+        Lock mutex_;
+        int evictSlack_;       // 允许暂时超出容量的节点数
+        bool evictScheduled_;  // 是否已提交后台淘汰任务
+        std::shared_ptr<ShardsTracker<Key>> tracker_; // 未命中率曲线估计器，可为空
+        MaintenanceHandle maintenance_; // 最后析构，先等待后台任务结束
     };
     /* LRU-k算法是对LRU算法的改进，基础的LRU算法被访问数据进入缓存队列只需要访问(put、get)一次就行，
     但是现在需要被访问k（大小自定义）次才能被放入缓存中，基础的LRU算法可以看成是LRU-1。 */
-    template <typename Key, typename Value>
-    class LruKCache : public LruCache<Key, Value>
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class LruKCache : public LruCache<Key, Value, Lock>
     {
     public:
-        LruKCache(int capacity, int historyCapacity, int k) : LruCache<Key, Value>(capacity), historyList_(std::make_unique<LruCache<Key, size_t>>(historyCapacity)), k_(k) {}
+        LruKCache(int capacity, int historyCapacity, int k) : LruCache<Key, Value, Lock>(capacity), historyList_(std::make_unique<LruCache<Key, size_t, Lock>>(historyCapacity)), k_(k) {}
         
         Value get(Key key)override{
             Value value{};
-            bool inMainCache=LruCache<Key,Value>::get(key,value);
+            bool inMainCache=LruCache<Key,Value,Lock>::get(key,value);
             if(inMainCache)
             {
                 return value;
@@ -197,7 +282,7 @@ namespace MyCache
                     historyList_->remove(key);
                     historyValueMap_.erase(it);
                     //添加到主缓存
-                    LruCache<Key,Value>::put(key,storedValue);
+                    LruCache<Key,Value,Lock>::put(key,storedValue);
                     return storedValue;
                 }
             }
@@ -206,10 +291,10 @@ namespace MyCache
 
         void put(Key key,Value value)override{
             Value existingValue{};
-            bool inMainCache=LruCache<Key,Value>::get(key,existingValue);
+            bool inMainCache=LruCache<Key,Value,Lock>::get(key,existingValue);
             if(inMainCache)
             {
-                LruCache<Key,Value>::put(key,value);
+                LruCache<Key,Value,Lock>::put(key,value);
                 return;
             }
 
@@ -223,56 +308,193 @@ namespace MyCache
                 //放入主缓存
                 historyValueMap_.erase(key);
                 historyList_->remove(key);
-                LruCache<Key,Value>::put(key,value);
+                LruCache<Key,Value,Lock>::put(key,value);
             }
         }
     private:
         // k_代表自定义大小
         int k_;
-        std::unique_ptr<LruCache<Key, size_t>> historyList_;
+        std::unique_ptr<LruCache<Key, size_t, Lock>> historyList_;
         std::unordered_map<Key, Value> historyValueMap_; // 存取未到K次的数据
     };
     template<typename Key,typename Value>
     class HashLruCache{
         public:
 
-            HashLruCache(size_t capacity,int sliceNum):capacity_(capacity),sliceNum_(sliceNum_>0?sliceNum_:std::thread::hardware_concurrency()){
-                int sliceSize=std::ceil(capacity/static_cast<double>(sliceNum_));
-                for(int i=0;i<sliceNum_;i++)
-                    lruSliceCaches_.emplace_back(new LruCache<Key,Value>(sliceSize));
+            // executor不为空时，所有分片共享该后台维护线程池
+            HashLruCache(size_t capacity,int sliceNum,std::shared_ptr<MaintenanceExecutor> executor=nullptr):capacity_(capacity),sliceNum_(sliceNum>0?sliceNum:std::thread::hardware_concurrency()),slicesPerNode_(sliceNum_),preferLocal_(false),executor_(executor){
+                buildSlices();
+            }
+
+            /* 开启NUMA模式(需在使用前调用，已有数据会被丢弃)：分片轮流放到各节点上，
+               分片对象和它的缓存节点都从所在节点的内存池分配。
+               preferLocal为true时按节点分区：每个节点有自己的一组分片，各占1/nodeCount的容量，
+               线程只在本节点的分区中查找和写入，put同时删除其他分区中的旧副本，不会读到过期数据。
+               适合key与线程有亲和性(如按会话分配线程)的场景；同一个key被多个节点交替写入时会在分区间来回迁移。 */
+            void setNumaTopology(std::shared_ptr<const NumaTopology> topology,bool preferLocal=false)
+            {
+                lruSliceCaches_.clear(); // 旧分片可能在旧的内存池上，先于内存池释放
+                topology_=std::move(topology);
+                int nodeCount=topology_->nodeCount();
+                preferLocal_=preferLocal&&nodeCount>1;
+                if(preferLocal_)
+                {
+                    slicesPerNode_=std::max(1,(sliceNum_+nodeCount-1)/nodeCount);
+                    sliceNum_=slicesPerNode_*nodeCount;
+                }
+                arenas_.clear();
+                for(int node=0;node<nodeCount;node++)
+                    arenas_.push_back(std::make_shared<NumaArena>(topology_,node));
+                buildSlices();
             }
 
             void put(Key key, Value value)
             {
                 // 获取key的hash值，并计算出对应的分片索引
-                size_t sliceIndex = Hash(key) % sliceNum_;
-                lruSliceCaches_[sliceIndex]->put(key, value);
+                size_t hashValue=Hash(key);
+                int node=localNode();
+                lruSliceCaches_[getSliceIndex(hashValue,node)]->put(key, value);
+                if(preferLocal_)
+                {
+                    for(int other=0;other<topology_->nodeCount();other++)
+                    {
+                        if(other!=node)
+                            lruSliceCaches_[getSliceIndex(hashValue,other)]->remove(key);
+                    }
+                }
             }
 
-            Value get(Key key, Value &value)
+            bool get(Key key, Value &value)
             {
-                size_t hashKey=Hash(key)%sliceNum_;
-                lruSliceCaches_[hashKey]->get(key,value);
-                return value;
+                size_t sliceIndex=getSliceIndex(Hash(key),localNode());
+                return lruSliceCaches_[sliceIndex]->get(key,value);
             }
             Value get(Key key)
             {
-                size_t hashKey=Hash(key)%sliceNum_;
                 Value value{};
                 get(key,value);
                 return value;
             }
+
+            void remove(Key key)
+            {
+                size_t hashValue=Hash(key);
+                if(!preferLocal_)
+                {
+                    lruSliceCaches_[getSliceIndex(hashValue,0)]->remove(key);
+                    return;
+                }
+                for(int node=0;node<topology_->nodeCount();node++)
+                    lruSliceCaches_[getSliceIndex(hashValue,node)]->remove(key);
+            }
+
+            size_t getCapacity() const {return capacity_.load(std::memory_order_relaxed);}
+
+            // 在线调整总容量，平均分到各分片；每个分片只在自己的锁内调整，缩容逐步进行(见LruCache::setCapacity)
+            void setCapacity(size_t capacity)
+            {
+                capacity_.store(capacity,std::memory_order_relaxed);
+                int sliceSize=std::ceil(capacity/static_cast<double>(sliceNum_));
+                for(auto &slice:lruSliceCaches_)
+                    slice->setCapacity(sliceSize);
+            }
+
+            // 每个分片淘汰最多maxCount个超出容量的节点，返回是否仍有分片超出容量
+            bool evictExcess(size_t maxCount)
+            {
+                bool remaining=false;
+                for(auto &slice:lruSliceCaches_)
+                    remaining=slice->evictExcess(maxCount)||remaining;
+                return remaining;
+            }
+
+            /* 逐个分片遍历，每个分片内的语义同LruCache::Scanner，同一时刻只在一个分片里挂游标。
+               NUMA分区模式下被其他节点重写、从后面的分区挪到已遍历分区的key可能漏掉。 */
+            class Scanner
+            {
+            public:
+                explicit Scanner(HashLruCache &cache):cache_(&cache),slice_(0){}
+
+                bool next(std::vector<std::pair<Key,Value>> &chunk,size_t maxCount)
+                {
+                    while(slice_<cache_->lruSliceCaches_.size())
+                    {
+                        if(!current_)
+                            current_.reset(new SliceScanner(*cache_->lruSliceCaches_[slice_]));
+                        if(current_->next(chunk,maxCount))
+                            return true;
+                        current_.reset();
+                        slice_++;
+                    }
+                    chunk.clear();
+                    return false;
+                }
+
+            private:
+                using SliceScanner=typename LruCache<Key,Value>::Scanner;
+                HashLruCache *cache_;
+                size_t slice_;
+                std::unique_ptr<SliceScanner> current_;
+            };
+
+            Scanner scan(){return Scanner(*this);}
+
+            // 调用线程访问key时落到的分片所在的节点，未开启NUMA模式时返回-1
+            int nodeOf(Key key)
+            {
+                if(!topology_)
+                    return -1;
+                return nodeOfSlice(getSliceIndex(Hash(key),localNode()));
+            }
         private:
 
             size_t Hash(Key key)
             {
                 std::hash<Key> hashFunc;
-                return hashFuck(key);
+                return hashFunc(key);
+            }
+
+            int localNode() const
+            {
+                return preferLocal_?topology_->currentNode():0;
+            }
+
+            // 按节点分区时每个节点的分片连续存放
+            size_t getSliceIndex(size_t hashValue,int node) const
+            {
+                if(preferLocal_)
+                    return node*slicesPerNode_+hashValue%slicesPerNode_;
+                return hashValue%sliceNum_;
+            }
+
+            int nodeOfSlice(size_t sliceIndex) const
+            {
+                return preferLocal_?sliceIndex/slicesPerNode_:sliceIndex%topology_->nodeCount();
+            }
+
+            void buildSlices()
+            {
+                lruSliceCaches_.clear();
+                int sliceSize=std::ceil(capacity_.load()/static_cast<double>(sliceNum_));
+                for(int i=0;i<sliceNum_;i++)
+                {
+                    std::shared_ptr<NumaArena> arena=topology_?arenas_[nodeOfSlice(i)]:nullptr;
+                    lruSliceCaches_.push_back(makeOnArena<LruCache<Key,Value>>(arena.get(),sliceSize));
+                    if(arena)
+                        lruSliceCaches_.back()->setNodeArena(arena);
+                    if(executor_)
+                        lruSliceCaches_.back()->setMaintenanceExecutor(executor_);
+                }
             }
 
-            size_t capacity_;//容量
+            std::atomic<size_t> capacity_;//容量
             int sliceNum_;//切片数量
-            std::vector<std::unique_ptr<LruCache<Key,Value>>> lruSliceCaches_;
+            int slicesPerNode_;//按节点分区时每个节点的切片数量
+            bool preferLocal_;//是否按节点分区
+            std::shared_ptr<MaintenanceExecutor> executor_;
+            std::shared_ptr<const NumaTopology> topology_;//为空时不区分节点
+            std::vector<std::shared_ptr<NumaArena>> arenas_;//每个节点一个内存池，在分片之后析构
+            std::vector<ArenaPtr<LruCache<Key,Value>>> lruSliceCaches_;
     };
     
 
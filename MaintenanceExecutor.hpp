@@ -0,0 +1,215 @@
+#pragma once
+
+#include "NodeLayout.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MyCache
+{
+    /* 后台维护线程池：所有分片共享，负责淘汰、老化、读缓冲区迁移等可以摊还的任务。
+       每个工作线程有自己的双端队列，本线程从队尾取任务，空闲时从其他线程队头窃取。
+       待执行任务数超过上限时拒绝提交(背压)，调用方应退回到在本线程同步执行。 */
+    class MaintenanceExecutor
+    {
+    public:
+        using Task = std::function<void()>;
+
+        explicit MaintenanceExecutor(int threadNum = 2, size_t maxPending = 1024)
+            : threadNum_(threadNum > 0 ? threadNum : 1), maxPending_(maxPending), pending_(0), queued_(0), nextQueue_(0), stop_(false)
+        {
+            queues_ = std::vector<WorkQueue, CacheLineAllocator<WorkQueue>>(threadNum_);
+            for (int i = 0; i < threadNum_; i++)
+                workers_.emplace_back(&MaintenanceExecutor::workerLoop, this, i);
+        }
+
+        // 停止前会执行完所有已接受的任务
+        ~MaintenanceExecutor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                stop_ = true;
+            }
+            sleepCond_.notify_all();
+            for (auto &worker : workers_)
+                worker.join();
+        }
+
+        MaintenanceExecutor(const MaintenanceExecutor &) = delete;
+        MaintenanceExecutor &operator=(const MaintenanceExecutor &) = delete;
+
+        // 提交任务，维护落后(待执行任务过多)时返回false
+        bool trySubmit(Task task)
+        {
+            if (pending_.fetch_add(1, std::memory_order_acq_rel) >= maxPending_)
+            {
+                pending_.fetch_sub(1, std::memory_order_acq_rel);
+                return false;
+            }
+            // 工作线程提交的任务放入自己的队列，外部线程轮流放入各个队列
+            const WorkerInfo &worker = currentWorker();
+            int index = worker.executor == this ? worker.index
+                                                : nextQueue_.fetch_add(1, std::memory_order_relaxed) % threadNum_;
+            queued_.fetch_add(1, std::memory_order_acq_rel);
+            {
+                std::lock_guard<std::mutex> lock(queues_[index].mutex);
+                queues_[index].tasks.push_back(std::move(task));
+            }
+            {
+                // 与工作线程的检查-睡眠配对，避免丢失唤醒
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+            }
+            sleepCond_.notify_one();
+            return true;
+        }
+
+        size_t pending() const { return pending_.load(std::memory_order_acquire); }
+
+        int threadNum() const { return threadNum_; }
+
+    private:
+        struct alignas(kCacheLineSize) WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        struct WorkerInfo
+        {
+            const MaintenanceExecutor *executor;
+            int index;
+        };
+
+        bool popLocal(int index, Task &task)
+        {
+            std::lock_guard<std::mutex> lock(queues_[index].mutex);
+            if (queues_[index].tasks.empty())
+                return false;
+            task = std::move(queues_[index].tasks.back());
+            queues_[index].tasks.pop_back();
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        bool steal(int thief, Task &task)
+        {
+            for (int i = 1; i < threadNum_; i++)
+            {
+                WorkQueue &victim = queues_[(thief + i) % threadNum_];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    queued_.fetch_sub(1, std::memory_order_acq_rel);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void workerLoop(int index)
+        {
+            currentWorker() = {this, index};
+            Task task;
+            while (true)
+            {
+                if (popLocal(index, task) || steal(index, task))
+                {
+                    task();
+                    task = nullptr;
+                    pending_.fetch_sub(1, std::memory_order_acq_rel);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                if (queued_.load(std::memory_order_acquire) > 0)
+                    continue; // 其他队列中还有任务，重新尝试窃取
+                if (stop_)
+                    break;
+                sleepCond_.wait(lock);
+            }
+            currentWorker() = {nullptr, 0};
+        }
+
+        int threadNum_;
+        size_t maxPending_;               // 待执行任务上限
+        std::atomic<size_t> pending_;     // 已接受但未执行完的任务数
+        std::atomic<size_t> queued_;      // 仍在队列中等待执行的任务数
+        std::atomic<unsigned> nextQueue_; // 外部提交的轮转下标
+        bool stop_;
+
+        std::vector<WorkQueue, CacheLineAllocator<WorkQueue>> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex sleepMutex_;
+        std::condition_variable sleepCond_;
+
+        // 当前线程所属的执行器及队列下标
+        static WorkerInfo &currentWorker()
+        {
+            thread_local WorkerInfo info = {nullptr, 0};
+            return info;
+        }
+    };
+
+    /* 缓存持有的维护句柄：记录本缓存提交但尚未执行完的任务，
+       析构时等待这些任务结束，保证任务里访问的缓存对象仍然有效。
+       应声明为缓存的最后一个成员，使其最先析构。 */
+    class MaintenanceHandle
+    {
+    public:
+        MaintenanceHandle() : scheduled_(0) {}
+
+        ~MaintenanceHandle() { waitIdle(); }
+
+        void setExecutor(std::shared_ptr<MaintenanceExecutor> executor)
+        {
+            waitIdle();
+            executor_ = std::move(executor);
+        }
+
+        bool enabled() const { return executor_ != nullptr; }
+
+        // 交给后台执行，没有执行器或执行器拒绝时返回false，调用方需自行同步执行
+        bool trySchedule(std::function<void()> task)
+        {
+            if (!executor_)
+                return false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                scheduled_++;
+            }
+            bool accepted = executor_->trySubmit([this, task]()
+                                                 {
+                task();
+                finishOne(); });
+            if (!accepted)
+                finishOne();
+            return accepted;
+        }
+
+        void waitIdle()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idleCond_.wait(lock, [this]()
+                           { return scheduled_ == 0; });
+        }
+
+    private:
+        void finishOne()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--scheduled_ == 0)
+                idleCond_.notify_all();
+        }
+
+        std::shared_ptr<MaintenanceExecutor> executor_;
+        std::mutex mutex_;
+        std::condition_variable idleCond_;
+        size_t scheduled_; // 已提交未完成的任务数
+    };
+}
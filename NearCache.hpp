@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "HashMix.h"
+#include "LruCache.hpp"
+#include "NodeLayout.h"
+#include "PerThreadCache.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace MyCache
+{
+    /* 两级缓存：每个线程一个直接映射的小表(L1)，挡在共享的分片缓存(L2)前面。
+       热点key的读在L1命中，不加锁，也不写任何共享的缓存行，不再挤在同一个分片的互斥锁上。
+       一致性靠分条带的版本号：key按哈希落到一个版本号上，put/remove先写L2再把版本号加一；
+       L1的条目记下填充前读到的版本号，命中时版本号不一致就作废重新从L2读，
+       因此put/remove返回之后，任何线程的L1都不会再返回更早的值。
+       L2自行淘汰的key在L1中可能还能读到，但读到的一定是最后一次写入的值；
+       L1命中不会更新L2的访问顺序，只在L1中热的key在L2里会逐渐变冷，整体命中率与单用L2基本持平。
+       所有写入都必须经过NearCache，绕过它直接写L2不会让L1失效。
+       L2需要提供get(Key, Value&)、put(Key, Value)，用到remove时还需要remove(Key)，且自身线程安全。 */
+    template <typename Key, typename Value, typename L2 = HashLruCache<Key, Value>>
+    class NearCache : public CachePolicy<Key, Value>
+    {
+    public:
+        // l1Slots为每个线程L1的槽数，versionStripes为版本号的条带数，都向上取为2的幂
+        NearCache(std::shared_ptr<L2> l2, size_t l1Slots = 256, size_t versionStripes = 1024)
+            : l2_(std::move(l2)), l1Slots_(roundUpPowerOfTwo(l1Slots)), versions_(roundUpPowerOfTwo(versionStripes)),
+              l1_([this]()
+                  { return std::unique_ptr<L1Table>(new L1Table(l1Slots_)); })
+        {
+        }
+
+        void put(Key key, Value value) override
+        {
+            std::atomic<uint64_t> &version = versionOf(hash(key));
+            l2_->put(key, value);
+            version.fetch_add(1, std::memory_order_release);
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            uint64_t h = hash(key);
+            const std::atomic<uint64_t> &version = versionOf(h);
+            L1Slot &slot = l1_.local().slots[h & (l1Slots_ - 1)];
+            uint64_t current = version.load(std::memory_order_acquire);
+            if (slot.valid && slot.version == current && slot.key == key)
+            {
+                value = slot.value;
+                return true;
+            }
+            // 先读版本号再读L2：期间有写入的话版本号已变，这次填充的条目下次访问就会作废
+            if (!l2_->get(key, value))
+                return false;
+            slot.valid = true;
+            slot.version = current;
+            slot.key = key;
+            slot.value = value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::atomic<uint64_t> &version = versionOf(hash(key));
+            l2_->remove(key);
+            version.fetch_add(1, std::memory_order_release);
+        }
+
+        L2 &l2() { return *l2_; }
+
+    private:
+        struct L1Slot
+        {
+            bool valid = false;
+            uint64_t version = 0;
+            Key key{};
+            Value value{};
+        };
+
+        // 只被所属线程访问
+        struct L1Table
+        {
+            explicit L1Table(size_t size) : slots(size) {}
+            std::vector<L1Slot> slots;
+        };
+
+        // 每个版本号独占一个缓存行，写入一个条带不会让读其他条带的线程缓存失效
+        struct alignas(kCacheLineSize) VersionStripe
+        {
+            std::atomic<uint64_t> version{0};
+        };
+
+        static size_t roundUpPowerOfTwo(size_t n)
+        {
+            size_t size = 1;
+            while (size < n)
+                size <<= 1;
+            return size;
+        }
+
+        // 高位选版本条带，低位选L1槽，二者互不相关
+        static uint64_t hash(const Key &key) { return mixKey(std::hash<Key>()(key)); }
+
+        std::atomic<uint64_t> &versionOf(uint64_t h)
+        {
+            return versions_[(h >> 32) & (versions_.size() - 1)].version;
+        }
+
+        std::shared_ptr<L2> l2_;
+        const size_t l1Slots_;
+        std::vector<VersionStripe, CacheLineAllocator<VersionStripe>> versions_;
+        PerThreadCache<L1Table> l1_;
+    };
+}
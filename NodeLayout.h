@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace MyCache
+{
+    constexpr size_t kCacheLineSize = 64;
+
+    // make_shared/allocate_shared把控制块(虚表指针+强弱两个计数)放在对象前面，命中时复制shared_ptr会写它
+    constexpr size_t kSharedControlBlockSize = sizeof(void *) + 2 * sizeof(int);
+
+    // 放在节点开头的热字段加上控制块能否放进同一个缓存行(节点按缓存行对齐分配时)
+    constexpr bool fitsSharedNodeLine(size_t hotBytes)
+    {
+        return kSharedControlBlockSize + hotBytes <= kCacheLineSize;
+    }
+
+    /* 按缓存行对齐分配的分配器，配合std::allocate_shared使用：
+       控制块和节点开头的热字段落在同一个缓存行里，命中时只需要碰一行。
+       C++14的new不保证alignas(64)这类超出默认对齐的类型按其对齐分配，
+       独占缓存行的条带、每线程记录等数组也用std::vector<T, CacheLineAllocator<T>>分配。 */
+    template <typename T>
+    class CacheLineAllocator
+    {
+    public:
+        using value_type = T;
+
+        CacheLineAllocator() = default;
+
+        template <typename U>
+        CacheLineAllocator(const CacheLineAllocator<U> &) {}
+
+        T *allocate(size_t n)
+        {
+            void *ptr = nullptr;
+            if (posix_memalign(&ptr, kCacheLineSize, n * sizeof(T)) != 0)
+                throw std::bad_alloc();
+            return static_cast<T *>(ptr);
+        }
+
+        void deallocate(T *ptr, size_t) { std::free(ptr); }
+
+        template <typename U>
+        bool operator==(const CacheLineAllocator<U> &) const { return true; }
+
+        template <typename U>
+        bool operator!=(const CacheLineAllocator<U> &) const { return false; }
+    };
+
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeCacheLineShared(Args &&...args)
+    {
+        return std::allocate_shared<T>(CacheLineAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "NodeLayout.h"
+#include "NumaTopology.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace MyCache
+{
+    /* 节点本地内存池：按块向系统申请内存并在首次写入前绑定到指定节点，
+       块内按大小类切分(不小于一个缓存行的按缓存行对齐)，释放的内存挂回对应大小类的空闲链表复用。
+       超过kMaxSmall的请求直接走operator new。整个池在析构时一次性归还。 */
+    class NumaArena
+    {
+    public:
+        static constexpr size_t kAlign = 16;
+        static constexpr size_t kMaxSmall = 512;
+
+        NumaArena(std::shared_ptr<const NumaTopology> topology, int node, size_t chunkSize = 1 << 20)
+            : topology_(std::move(topology)), node_(node), chunkSize_(chunkSize), bound_(true),
+              cursor_(nullptr), remaining_(0), freeLists_(kMaxSmall / kAlign + 1, nullptr)
+        {
+        }
+
+        ~NumaArena()
+        {
+            for (auto &chunk : chunks_)
+                releaseChunk(chunk.first, chunk.second);
+        }
+
+        NumaArena(const NumaArena &) = delete;
+        NumaArena &operator=(const NumaArena &) = delete;
+
+        void *allocate(size_t size)
+        {
+            if (size > kMaxSmall)
+                return ::operator new(size);
+            size_t bytes = blockSize(size);
+            std::lock_guard<std::mutex> lock(mutex_);
+            FreeBlock *&head = freeLists_[bytes / kAlign];
+            if (head)
+            {
+                FreeBlock *block = head;
+                head = block->next;
+                return block;
+            }
+            // 整缓存行大小的块从缓存行边界开始切分，节点开头的热字段不会跨行
+            size_t padding = 0;
+            if (bytes % kCacheLineSize == 0 && cursor_)
+                padding = (kCacheLineSize - reinterpret_cast<uintptr_t>(cursor_) % kCacheLineSize) % kCacheLineSize;
+            if (remaining_ < padding + bytes)
+            {
+                newChunk();
+                padding = 0;
+            }
+            void *result = cursor_ + padding;
+            cursor_ += padding + bytes;
+            remaining_ -= padding + bytes;
+            return result;
+        }
+
+        void deallocate(void *ptr, size_t size)
+        {
+            if (size > kMaxSmall)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            FreeBlock *block = static_cast<FreeBlock *>(ptr);
+            FreeBlock *&head = freeLists_[blockSize(size) / kAlign];
+            block->next = head;
+            head = block;
+        }
+
+        int node() const { return node_; }
+
+        // 所有块是否都成功绑定到了本节点(模拟拓扑或不支持mbind时为false)
+        bool bound()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return bound_ && !chunks_.empty();
+        }
+
+        size_t reservedBytes()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return chunks_.size() * chunkSize_;
+        }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        // 不小于一个缓存行的块按缓存行取整，其余按16字节取整
+        static size_t blockSize(size_t size)
+        {
+            size_t align = size >= kCacheLineSize ? kCacheLineSize : kAlign;
+            return (size + align - 1) / align * align;
+        }
+
+        void newChunk()
+        {
+            void *chunk = nullptr;
+#ifdef __linux__
+            chunk = mmap(nullptr, chunkSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (chunk == MAP_FAILED)
+                chunk = nullptr;
+#endif
+            bool mapped = chunk != nullptr;
+            if (mapped)
+                bound_ = topology_->bindMemory(chunk, chunkSize_, node_) && bound_;
+            else
+            {
+                chunk = ::operator new(chunkSize_); // 没有mmap时退回普通分配，只是不绑定节点
+                bound_ = false;
+            }
+            chunks_.emplace_back(chunk, mapped);
+            cursor_ = static_cast<char *>(chunk);
+            remaining_ = chunkSize_;
+        }
+
+        void releaseChunk(void *chunk, bool mapped)
+        {
+#ifdef __linux__
+            if (mapped)
+            {
+                munmap(chunk, chunkSize_);
+                return;
+            }
+#endif
+            (void)mapped;
+            ::operator delete(chunk);
+        }
+
+        std::shared_ptr<const NumaTopology> topology_;
+        int node_;
+        size_t chunkSize_;
+        std::mutex mutex_;
+        bool bound_;
+        char *cursor_;     // 当前块中未切分部分的起点
+        size_t remaining_; // 当前块剩余字节数
+        std::vector<FreeBlock *> freeLists_;
+        std::vector<std::pair<void *, bool>> chunks_; // 块地址，是否由mmap分配
+    };
+
+    // 从NumaArena分配的标准分配器，可用于std::allocate_shared和容器；arena为空时按缓存行对齐从普通堆分配
+    template <typename T>
+    class NumaAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit NumaAllocator(NumaArena *arena = nullptr) : arena_(arena) {}
+
+        template <typename U>
+        NumaAllocator(const NumaAllocator<U> &other) : arena_(other.arena()) {}
+
+        T *allocate(size_t n)
+        {
+            static_assert(alignof(T) <= NumaArena::kAlign, "对齐要求超过内存池的对齐");
+            if (!arena_)
+                return CacheLineAllocator<T>().allocate(n);
+            return static_cast<T *>(arena_->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T *ptr, size_t n)
+        {
+            if (!arena_)
+                CacheLineAllocator<T>().deallocate(ptr, n);
+            else
+                arena_->deallocate(ptr, n * sizeof(T));
+        }
+
+        NumaArena *arena() const { return arena_; }
+
+        template <typename U>
+        bool operator==(const NumaAllocator<U> &other) const { return arena_ == other.arena(); }
+
+        template <typename U>
+        bool operator!=(const NumaAllocator<U> &other) const { return arena_ != other.arena(); }
+
+    private:
+        NumaArena *arena_;
+    };
+
+    // arena为空时是普通的delete，否则析构后把内存还给arena
+    template <typename T>
+    struct ArenaDelete
+    {
+        NumaArena *arena = nullptr;
+
+        void operator()(T *ptr) const
+        {
+            if (!arena)
+            {
+                delete ptr;
+                return;
+            }
+            ptr->~T();
+            arena->deallocate(ptr, sizeof(T));
+        }
+    };
+
+    template <typename T>
+    using ArenaPtr = std::unique_ptr<T, ArenaDelete<T>>;
+
+    // arena为空时在普通堆上创建
+    template <typename T, typename... Args>
+    ArenaPtr<T> makeOnArena(NumaArena *arena, Args &&...args)
+    {
+        if (!arena)
+            return ArenaPtr<T>(new T(std::forward<Args>(args)...));
+        void *memory = arena->allocate(sizeof(T));
+        return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...), ArenaDelete<T>{arena});
+    }
+}
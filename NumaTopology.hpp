@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace MyCache
+{
+    /* NUMA拓扑：从/sys/devices/system/node读取各节点的CPU列表，读不到时视为单节点。
+       simulated(n)在单节点机器上模拟n个节点：线程按bindCurrentThread指定的节点(或轮流分配)归属，
+       不绑定CPU也不绑定内存，只用于验证放置逻辑和在任意机器上跑性能测试。 */
+    class NumaTopology
+    {
+    public:
+        static NumaTopology detect()
+        {
+            NumaTopology topology;
+            std::vector<int> online = parseCpuList(readFile("/sys/devices/system/node/online"));
+            for (int node : online)
+            {
+                std::vector<int> cpus = parseCpuList(readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+                if (cpus.empty())
+                    continue; // 只有内存没有CPU的节点不放分片
+                topology.addNode(node, cpus);
+            }
+            if (topology.nodeCpus_.empty())
+            {
+                std::vector<int> cpus;
+                for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++)
+                    cpus.push_back(static_cast<int>(cpu));
+                topology.addNode(0, cpus);
+            }
+            return topology;
+        }
+
+        static NumaTopology simulated(int nodeCount)
+        {
+            NumaTopology topology;
+            topology.simulated_ = true;
+            for (int node = 0; node < std::max(1, nodeCount); node++)
+                topology.addNode(node, std::vector<int>());
+            return topology;
+        }
+
+        int nodeCount() const { return static_cast<int>(nodeCpus_.size()); }
+        bool isSimulated() const { return simulated_; }
+
+        // 系统中的节点编号，mbind需要
+        int systemNodeId(int node) const { return nodeIds_[node]; }
+
+        // 调用线程所在的节点(0..nodeCount-1)
+        int currentNode() const
+        {
+            ThreadNode &bound = boundNode();
+            if (bound.topology == this)
+                return bound.node;
+            if (simulated_)
+            {
+                bound.topology = this;
+                bound.node = static_cast<int>(nextThread() % nodeCpus_.size());
+                return bound.node;
+            }
+#ifdef __linux__
+            int cpu = sched_getcpu();
+            if (cpu >= 0 && static_cast<size_t>(cpu) < cpuToNode_.size())
+                return cpuToNode_[cpu];
+#endif
+            return 0;
+        }
+
+        // 把调用线程固定在node的CPU上，之后currentNode直接返回node；模拟模式下只记录归属
+        bool bindCurrentThread(int node) const
+        {
+            bool pinned = simulated_;
+#ifdef __linux__
+            if (!simulated_)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (int cpu : nodeCpus_[node])
+                    CPU_SET(cpu, &set);
+                pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+            }
+#endif
+            if (pinned)
+            {
+                boundNode().topology = this;
+                boundNode().node = node;
+            }
+            return pinned;
+        }
+
+        // 把[addr, addr+length)绑定到node的内存上，需在首次写入前调用；不支持或失败时返回false，内存仍可正常使用
+        bool bindMemory(void *addr, size_t length, int node) const
+        {
+            if (simulated_)
+                return false;
+#if defined(__linux__) && defined(SYS_mbind)
+            const int kMpolBind = 2; // 与numaif.h中的MPOL_BIND一致，直接走系统调用，不依赖libnuma
+            int systemNode = nodeIds_[node];
+            const size_t kBits = sizeof(unsigned long) * 8;
+            std::vector<unsigned long> mask(systemNode / kBits + 1, 0);
+            mask[systemNode / kBits] |= 1UL << (systemNode % kBits);
+            return syscall(SYS_mbind, addr, length, kMpolBind, mask.data(), mask.size() * kBits + 1, 0) == 0;
+#else
+            (void)addr;
+            (void)length;
+            (void)node;
+            return false;
+#endif
+        }
+
+    private:
+        struct ThreadNode
+        {
+            const NumaTopology *topology = nullptr;
+            int node = 0;
+        };
+
+        NumaTopology() : simulated_(false) {}
+
+        void addNode(int systemNode, const std::vector<int> &cpus)
+        {
+            int node = static_cast<int>(nodeCpus_.size());
+            nodeIds_.push_back(systemNode);
+            nodeCpus_.push_back(cpus);
+            for (int cpu : cpus)
+            {
+                if (static_cast<size_t>(cpu) >= cpuToNode_.size())
+                    cpuToNode_.resize(cpu + 1, 0);
+                cpuToNode_[cpu] = node;
+            }
+        }
+
+        static ThreadNode &boundNode()
+        {
+            thread_local ThreadNode bound;
+            return bound;
+        }
+
+        static size_t nextThread()
+        {
+            static std::atomic<size_t> next(0);
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static std::string readFile(const std::string &path)
+        {
+            std::ifstream file(path);
+            std::string content;
+            std::getline(file, content);
+            return content;
+        }
+
+        // 解析"0-3,8-11"格式
+        static std::vector<int> parseCpuList(const std::string &text)
+        {
+            std::vector<int> result;
+            std::stringstream stream(text);
+            std::string range;
+            while (std::getline(stream, range, ','))
+            {
+                if (range.empty())
+                    continue;
+                size_t dash = range.find('-');
+                int first = std::atoi(range.substr(0, dash).c_str());
+                int last = dash == std::string::npos ? first : std::atoi(range.substr(dash + 1).c_str());
+                for (int cpu = first; cpu <= last; cpu++)
+                    result.push_back(cpu);
+            }
+            return result;
+        }
+
+        bool simulated_;
+        std::vector<int> nodeIds_;               // 下标为节点序号，值为系统节点编号
+        std::vector<std::vector<int>> nodeCpus_;
+        std::vector<int> cpuToNode_;
+    };
+}
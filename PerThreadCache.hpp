@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace MyCache
+{
+    /* 每线程独占的缓存：为每个访问过的线程创建一个Cache实例，按线程ID路由，线程之间不共享任何数据。
+       适合thread-per-core的服务端，Cache一般取不加锁的版本，如LruCache<K, V, NullLock>。
+       热路径只比较一次线程局部的缓存指针；在多个包装器之间交替访问时查线程局部的编号表，同样不加锁；
+       线程第一次访问某个包装器时才加锁登记。实例在包装器析构时统一释放，因此某个线程退出后它的实例仍保留。 */
+    template <typename Cache>
+    class PerThreadCache
+    {
+    public:
+        using Factory = std::function<std::unique_ptr<Cache>()>;
+
+        explicit PerThreadCache(Factory factory) : factory_(std::move(factory)), id_(nextId()) {}
+
+        explicit PerThreadCache(int capacityPerThread)
+            : PerThreadCache([capacityPerThread]()
+                             { return std::unique_ptr<Cache>(new Cache(capacityPerThread)); }) {}
+
+        PerThreadCache(const PerThreadCache &) = delete;
+        PerThreadCache &operator=(const PerThreadCache &) = delete;
+
+        template <typename Key, typename Value>
+        void put(const Key &key, const Value &value)
+        {
+            local().put(key, value);
+        }
+
+        template <typename Key, typename Value>
+        bool get(const Key &key, Value &value)
+        {
+            return local().get(key, value);
+        }
+
+        // 当前线程的实例
+        Cache &local()
+        {
+            LocalSlot &slot = localSlot();
+            if (slot.ownerId != id_)
+            {
+                auto it = slot.byId.find(id_);
+                if (it != slot.byId.end())
+                {
+                    slot.cache = it->second;
+                }
+                else
+                {
+                    slot.cache = registerThread();
+                    // 已析构包装器的条目不会再命中，超过上限就整体清空，之后按需重新登记(实例还在，不会重复创建)
+                    if (slot.byId.size() >= kMaxLocalEntries)
+                        slot.byId.clear();
+                    slot.byId.emplace(id_, slot.cache);
+                }
+                slot.ownerId = id_;
+            }
+            return *slot.cache;
+        }
+
+        size_t instanceCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return instances_.size();
+        }
+
+    private:
+        static constexpr size_t kMaxLocalEntries = 64;
+
+        // 线程局部的缓存：最近一次使用的包装器编号及其实例，以及本线程用过的各个包装器
+        struct LocalSlot
+        {
+            uint64_t ownerId = 0;
+            Cache *cache = nullptr;
+            std::unordered_map<uint64_t, Cache *> byId;
+        };
+
+        static LocalSlot &localSlot()
+        {
+            thread_local LocalSlot slot;
+            return slot;
+        }
+
+        // 编号全局递增且不复用，已析构的包装器不会被误认
+        static uint64_t nextId()
+        {
+            static std::atomic<uint64_t> counter(0);
+            return ++counter;
+        }
+
+        Cache *registerThread()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = threadToInstance_.find(std::this_thread::get_id());
+            if (it != threadToInstance_.end())
+                return it->second;
+            instances_.push_back(factory_());
+            Cache *cache = instances_.back().get();
+            threadToInstance_.emplace(std::this_thread::get_id(), cache);
+            return cache;
+        }
+
+        Factory factory_;
+        const uint64_t id_;
+        std::mutex mutex_; // 只保护线程登记
+        std::deque<std::unique_ptr<Cache>> instances_;
+        std::unordered_map<std::thread::id, Cache *> threadToInstance_;
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "MaintenanceExecutor.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace MyCache
+{
+    /* 提前刷新：在任意缓存策略外包一层写入时间。
+       - 写入超过refreshAfter的条目仍然有效，命中时立即返回旧值，同时在后台重新加载；
+       - 同一个key同时最多只有一个刷新任务，刷新失败时保留旧值，下次命中再试；
+       - 刷新期间被put覆盖过的key丢弃加载结果，较旧的加载值不会盖掉新写入的值；
+       - expireAfter大于0时，写入超过expireAfter的条目视为未命中，由调用方同步加载。
+       refreshAfter小于expireAfter时，持续被访问的热点key不会出现同步未命中。
+       refreshAfter为0表示不刷新；没有执行器或执行器拒绝时本次不刷新。 */
+    template <typename Key, typename Value>
+    class RefreshAheadCache : public CachePolicy<Key, Value>
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry
+        {
+            Value value{};
+            Clock::time_point writeTime;
+        };
+
+        using InnerCache = CachePolicy<Key, Entry>;
+        using Loader = std::function<bool(const Key &key, Value &value)>; // 在后台线程调用，返回是否加载成功
+
+        RefreshAheadCache(std::unique_ptr<InnerCache> cache, Loader loader, Clock::duration refreshAfter,
+                          std::shared_ptr<MaintenanceExecutor> executor, Clock::duration expireAfter = Clock::duration::zero())
+            : cache_(std::move(cache)), loader_(std::move(loader)), refreshAfter_(refreshAfter), expireAfter_(expireAfter)
+        {
+            maintenance_.setExecutor(std::move(executor));
+        }
+
+        void put(Key key, Value value) override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = refreshing_.find(key);
+                if (it != refreshing_.end())
+                    it->second = true;
+            }
+            cache_->put(key, Entry{std::move(value), Clock::now()});
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            Entry entry;
+            if (!cache_->get(key, entry))
+                return false;
+            Clock::duration age = Clock::now() - entry.writeTime;
+            if (expireAfter_ > Clock::duration::zero() && age >= expireAfter_)
+                return false;
+            if (refreshAfter_ > Clock::duration::zero() && age >= refreshAfter_)
+                scheduleRefresh(key);
+            value = std::move(entry.value);
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        // 当前正在刷新的key数
+        size_t refreshingCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return refreshing_.size();
+        }
+
+    private:
+        void scheduleRefresh(const Key &key)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!refreshing_.emplace(key, false).second)
+                    return;
+            }
+            bool accepted = maintenance_.trySchedule([this, key]()
+                                                     {
+                Value value{};
+                bool loaded = loader_(key, value);
+                // 写回在锁内：之前标记过的put使这次结果作废，之后的put一定写在它后面
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = refreshing_.find(key);
+                if (loaded && !it->second)
+                    cache_->put(key, Entry{std::move(value), Clock::now()});
+                refreshing_.erase(it); });
+            if (!accepted)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                refreshing_.erase(key);
+            }
+        }
+
+        std::unique_ptr<InnerCache> cache_;
+        Loader loader_;
+        Clock::duration refreshAfter_;
+        Clock::duration expireAfter_;
+        std::mutex mutex_;                         // 保护refreshing_
+        std::unordered_map<Key, bool> refreshing_; // 刷新任务已提交的key -> 刷新期间是否被put覆盖过
+        MaintenanceHandle maintenance_;    // 最后析构，先等待后台刷新结束
+    };
+}
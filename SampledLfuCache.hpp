@@ -0,0 +1,227 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace MyCache
+{
+    /* 近似LFU(参考Redis的LFU实现)：
+       - 所有条目放在一张开放寻址(线性探测)的扁平表里，没有链表和频次桶；
+       - 每个条目只附带8位对数计数器和16位最近衰减时间，命中时只修改条目本身；
+       - 淘汰时随机采样sampleNum个条目，淘汰衰减后计数最小的那个。
+       时间采用逻辑时钟：每decayPeriod次访问为一个周期，每过一个周期计数器减1。 */
+    template <typename Key, typename Value>
+    class SampledLfuCache : public CachePolicy<Key, Value>
+    {
+    private:
+        // 元数据紧跟在key后面，小key时可以填进对齐空隙
+        struct Entry
+        {
+            Key key;
+            uint16_t ldt;    // 最近一次衰减的时间(周期数的低16位)
+            uint8_t counter; // 对数访问计数
+            bool used;       // 槽位是否被占用
+            Value value;
+        };
+
+        static constexpr uint8_t kInitCounter = 5; // 新条目的初始计数，避免刚插入就被淘汰
+
+    public:
+        explicit SampledLfuCache(int capacity, int sampleNum = 5, int logFactor = 10, uint32_t decayPeriod = 0)
+            : capacity_(capacity), size_(0), sampleNum_(sampleNum > 0 ? sampleNum : 1), logFactor_(logFactor),
+              decayPeriod_(decayPeriod > 0 ? decayPeriod : static_cast<uint32_t>(capacity > 0 ? capacity * 4 : 1)),
+              clock_(0), randState_(0x9E3779B97F4A7C15ULL)
+        {
+            // 负载因子不超过0.75，表长取2的幂便于取模
+            size_t tableSize = 8;
+            while (tableSize * 3 < static_cast<size_t>(capacity > 0 ? capacity : 0) * 4)
+                tableSize <<= 1;
+            table_.resize(tableSize);
+            for (auto &entry : table_)
+                entry.used = false;
+            mask_ = tableSize - 1;
+        }
+
+        ~SampledLfuCache() override = default;
+
+        void put(Key key, Value value) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (capacity_ <= 0)
+                return;
+            size_t index;
+            if (findSlot(key, index))
+            {
+                table_[index].value = value;
+                touch(table_[index]);
+                return;
+            }
+            if (size_ >= static_cast<size_t>(capacity_))
+            {
+                evict();
+                findSlot(key, index); // 淘汰可能移动了条目，重新定位空槽
+            }
+            Entry &entry = table_[index];
+            entry.key = key;
+            entry.value = value;
+            entry.counter = kInitCounter;
+            entry.ldt = currentPeriod();
+            entry.used = true;
+            size_++;
+            tick();
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t index;
+            if (!findSlot(key, index))
+                return false;
+            touch(table_[index]);
+            value = table_[index].value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t index;
+            if (findSlot(key, index))
+                eraseAt(index);
+        }
+
+        size_t size()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return size_;
+        }
+
+        // 每个条目除键值外的元数据字节数(含对齐填充)
+        static constexpr size_t metadataBytes() { return sizeof(Entry) - sizeof(Key) - sizeof(Value); }
+
+    private:
+        size_t home(const Key &key) const
+        {
+            return std::hash<Key>()(key) & mask_;
+        }
+
+        // 找到key所在槽位返回true；否则index为可插入的空槽
+        bool findSlot(const Key &key, size_t &index) const
+        {
+            index = home(key);
+            while (table_[index].used)
+            {
+                if (table_[index].key == key)
+                    return true;
+                index = (index + 1) & mask_;
+            }
+            return false;
+        }
+
+        uint16_t currentPeriod() const
+        {
+            return static_cast<uint16_t>(clock_ / decayPeriod_);
+        }
+
+        void tick() { clock_++; }
+
+        // 按经过的周期数衰减计数，16位时间回绕时按模计算
+        uint8_t decayedCounter(const Entry &entry) const
+        {
+            uint16_t elapsed = static_cast<uint16_t>(currentPeriod() - entry.ldt);
+            return elapsed >= entry.counter ? 0 : static_cast<uint8_t>(entry.counter - elapsed);
+        }
+
+        void touch(Entry &entry)
+        {
+            uint8_t counter = decayedCounter(entry);
+            entry.counter = logIncrement(counter);
+            entry.ldt = currentPeriod();
+            tick();
+        }
+
+        // 对数递增：计数越大，递增的概率越小
+        uint8_t logIncrement(uint8_t counter)
+        {
+            if (counter == 255)
+                return counter;
+            double base = counter > kInitCounter ? counter - kInitCounter : 0;
+            double probability = 1.0 / (base * logFactor_ + 1);
+            return nextRandom() < probability * UINT32_MAX ? counter + 1 : counter;
+        }
+
+        uint32_t nextRandom()
+        {
+            // xorshift64
+            randState_ ^= randState_ << 13;
+            randState_ ^= randState_ >> 7;
+            randState_ ^= randState_ << 17;
+            return static_cast<uint32_t>(randState_ >> 32);
+        }
+
+        void evict()
+        {
+            size_t victim = 0;
+            int victimCounter = 256;
+            for (int i = 0; i < sampleNum_; i++)
+            {
+                // 随机位置向后找第一个被占用的槽位
+                size_t index = nextRandom() & mask_;
+                while (!table_[index].used)
+                    index = (index + 1) & mask_;
+                int counter = decayedCounter(table_[index]);
+                if (counter < victimCounter)
+                {
+                    victimCounter = counter;
+                    victim = index;
+                }
+            }
+            eraseAt(victim);
+        }
+
+        // 线性探测的后移删除，不留墓碑
+        void eraseAt(size_t index)
+        {
+            size_t hole = index;
+            size_t next = (hole + 1) & mask_;
+            while (table_[next].used)
+            {
+                size_t ideal = home(table_[next].key);
+                // ideal不在(hole, next]区间内时，该条目可以前移填补空洞
+                bool movable = hole <= next ? (ideal <= hole || ideal > next)
+                                            : (ideal <= hole && ideal > next);
+                if (movable)
+                {
+                    table_[hole] = std::move(table_[next]);
+                    hole = next;
+                }
+                next = (next + 1) & mask_;
+            }
+            table_[hole].used = false;
+            table_[hole].key = Key();
+            table_[hole].value = Value();
+            size_--;
+        }
+
+        int capacity_;
+        size_t size_;
+        int sampleNum_;        // 淘汰时的采样数量
+        int logFactor_;        // 对数递增因子
+        uint32_t decayPeriod_; // 每个衰减周期包含的访问次数
+        uint64_t clock_;       // 逻辑时钟(访问次数)
+        uint64_t randState_;
+        size_t mask_;
+        std::vector<Entry> table_;
+        std::mutex mutex_;
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../Engine/InlineString.hpp"
+#include "../LruCache.hpp"
+#include "../LfuCache.hpp"
+#include "../ArcCache/ArcCache.hpp"
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <string>
+
+namespace MyCache
+{
+    using ServerKey = InlineString<>;
+
+    // 缓存中保存的条目，写入后不再修改；读到的条目以shared_ptr持有，直到回复写完
+    struct ServerItem
+    {
+        uint32_t flags;
+        uint64_t cas;
+        time_t expireAt; // 0表示不过期
+        std::string data;
+    };
+
+    using ServerItemPtr = std::shared_ptr<const ServerItem>;
+
+    /* 服务端使用的缓存后端，屏蔽HashLruCache/HashLfuCache/ArcCache的接口差异。
+       这几个策略没有删除接口，delete写入空指针作为墓碑，读到墓碑视为未命中，墓碑随普通条目一起被淘汰。 */
+    class CacheBackend
+    {
+    public:
+        virtual ~CacheBackend() = default;
+
+        // 过期的条目和墓碑都返回false
+        bool get(const ServerKey &key, ServerItemPtr &item)
+        {
+            if (!lookup(key, item) || !item)
+                return false;
+            if (item->expireAt != 0 && item->expireAt <= std::time(nullptr))
+            {
+                item.reset();
+                return false;
+            }
+            return true;
+        }
+
+        // exptime按memcached的约定：0不过期，不超过30天为相对秒数，否则为unix时间，负数立即过期
+        void set(const ServerKey &key, uint32_t flags, int64_t exptime, const char *data, size_t size)
+        {
+            const int64_t kMaxRelative = 60 * 60 * 24 * 30;
+            time_t now = std::time(nullptr);
+            time_t expireAt = 0;
+            if (exptime < 0)
+                expireAt = now;
+            else if (exptime > kMaxRelative)
+                expireAt = static_cast<time_t>(exptime);
+            else if (exptime > 0)
+                expireAt = now + static_cast<time_t>(exptime);
+            uint64_t cas = nextCas_.fetch_add(1, std::memory_order_relaxed);
+            store(key, std::make_shared<const ServerItem>(ServerItem{flags, cas, expireAt, std::string(data, size)}));
+        }
+
+        bool remove(const ServerKey &key)
+        {
+            ServerItemPtr item;
+            if (!get(key, item))
+                return false;
+            store(key, nullptr);
+            return true;
+        }
+
+    protected:
+        virtual bool lookup(const ServerKey &key, ServerItemPtr &item) = 0;
+        virtual void store(const ServerKey &key, ServerItemPtr item) = 0;
+
+    private:
+        std::atomic<uint64_t> nextCas_{1};
+    };
+
+    // Cache需要提供get(Key, Value&)和put(Key, Value)，且自身线程安全
+    template <typename Cache>
+    class CacheBackendAdapter : public CacheBackend
+    {
+    public:
+        template <typename... Args>
+        explicit CacheBackendAdapter(Args &&...args) : cache_(std::forward<Args>(args)...) {}
+
+    protected:
+        bool lookup(const ServerKey &key, ServerItemPtr &item) override { return cache_.get(key, item); }
+        void store(const ServerKey &key, ServerItemPtr item) override { cache_.put(key, std::move(item)); }
+
+    private:
+        Cache cache_;
+    };
+
+    // policy为lru/lfu/arc，sliceNum只对分片的lru/lfu有效，0表示按CPU核数分片；不认识的策略返回空指针
+    inline std::unique_ptr<CacheBackend> makeCacheBackend(const std::string &policy, size_t capacity, int sliceNum)
+    {
+        if (policy == "lru")
+            return std::unique_ptr<CacheBackend>(new CacheBackendAdapter<HashLruCache<ServerKey, ServerItemPtr>>(capacity, sliceNum));
+        if (policy == "lfu")
+            return std::unique_ptr<CacheBackend>(new CacheBackendAdapter<HashLfuCache<ServerKey, ServerItemPtr>>(static_cast<int>(capacity), sliceNum));
+        if (policy == "arc")
+            return std::unique_ptr<CacheBackend>(new CacheBackendAdapter<ArcCache<ServerKey, ServerItemPtr>>(capacity));
+        return nullptr;
+    }
+}
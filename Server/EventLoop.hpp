@@ -0,0 +1,415 @@
+#pragma once
+
+#include "CacheBackend.hpp"
+#include "MemcacheProtocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace MyCache
+{
+    /* 一个连接的读写状态。
+       读：请求在读缓冲区上原地解析，一次读到的所有完整请求处理完才把剩余字节移到缓冲区开头。
+       写：回复由多个片段组成，命中的value直接引用缓存条目(持有shared_ptr)，只有VALUE行等短文本写入scratch_；
+       一批请求的回复攒齐后用writev一次发出，写不完时注册EPOLLOUT等待可写。 */
+    class MemcacheConnection
+    {
+    public:
+        MemcacheConnection(int fd, CacheBackend &backend, MemcacheParser &parser)
+            : fd_(fd), backend_(backend), parser_(parser), readBegin_(0), readEnd_(0), skipBytes_(0),
+              writeIndex_(0), writeOffset_(0), closing_(false), waitingWrite_(false)
+        {
+            readBuffer_.resize(kInitialBufferSize);
+        }
+
+        ~MemcacheConnection() { ::close(fd_); }
+
+        int fd() const { return fd_; }
+        bool waitingWrite() const { return waitingWrite_; }
+
+        // 读到EAGAIN为止并处理所有完整请求，返回false表示连接应关闭
+        bool onReadable()
+        {
+            while (true)
+            {
+                if (readEnd_ == readBuffer_.size())
+                    makeRoom();
+                ssize_t n = ::read(fd_, readBuffer_.data() + readEnd_, readBuffer_.size() - readEnd_);
+                if (n > 0)
+                {
+                    // 每读一次就把这批请求的回复写出去，对端写得再快回复也不会无限堆积
+                    readEnd_ += n;
+                    bool more = processRequests();
+                    if (!flush())
+                        return false;
+                    if (!more || waitingWrite_)
+                        break;
+                    continue;
+                }
+                if (n == 0)
+                    return false;
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                return false;
+            }
+            return !(closing_ && !waitingWrite_);
+        }
+
+        bool onWritable()
+        {
+            return flush() && !(closing_ && !waitingWrite_);
+        }
+
+    private:
+        struct Segment
+        {
+            const char *external; // 为空时数据在scratch_[offset, offset + size)
+            size_t offset;
+            size_t size;
+        };
+
+        static constexpr size_t kInitialBufferSize = 16 * 1024;
+        static constexpr size_t kMaxIov = 512;
+
+        // 返回false表示收到quit或协议错误，后面的数据不再处理
+        bool processRequests()
+        {
+            while (readBegin_ < readEnd_ && !closing_)
+            {
+                if (skipBytes_ > 0)
+                {
+                    size_t skipped = std::min(skipBytes_, readEnd_ - readBegin_);
+                    readBegin_ += skipped;
+                    skipBytes_ -= skipped;
+                    continue;
+                }
+                size_t consumed = 0;
+                const char *begin = readBuffer_.data() + readBegin_;
+                MemcacheParser::Result result = parser_.parse(begin, readBuffer_.data() + readEnd_, request_, consumed);
+                if (result == MemcacheParser::Result::NeedMore)
+                    break;
+                readBegin_ += consumed;
+                if (result == MemcacheParser::Result::Ok)
+                {
+                    execute(request_);
+                    continue;
+                }
+                appendConst(request_.error);
+                if (result == MemcacheParser::Result::TooLarge)
+                    skipBytes_ = request_.bytes + 2;
+                else if (result == MemcacheParser::Result::Fatal)
+                    closing_ = true;
+            }
+            if (readBegin_ == readEnd_)
+                readBegin_ = readEnd_ = 0;
+            return !closing_;
+        }
+
+        void execute(const MemcacheRequest &request)
+        {
+            switch (request.command)
+            {
+            case MemcacheCommand::Get:
+            case MemcacheCommand::Gets:
+            {
+                // 多key的get逐个查找，所有VALUE片段和END一起写出
+                bool withCas = request.command == MemcacheCommand::Gets;
+                for (const Slice &key : request.keys)
+                {
+                    ServerItemPtr item;
+                    if (!backend_.get(ServerKey(key.data, key.size), item))
+                        continue;
+                    size_t offset = scratch_.size();
+                    scratch_.append("VALUE ", 6).append(key.data, key.size);
+                    scratch_ += ' ';
+                    scratch_ += std::to_string(item->flags);
+                    scratch_ += ' ';
+                    scratch_ += std::to_string(item->data.size());
+                    if (withCas)
+                    {
+                        scratch_ += ' ';
+                        scratch_ += std::to_string(item->cas);
+                    }
+                    scratch_.append("\r\n", 2);
+                    segments_.push_back(Segment{nullptr, offset, scratch_.size() - offset});
+                    if (!item->data.empty())
+                        segments_.push_back(Segment{item->data.data(), 0, item->data.size()});
+                    appendConst("\r\n");
+                    pinned_.push_back(std::move(item));
+                }
+                appendConst("END\r\n");
+                break;
+            }
+            case MemcacheCommand::Set:
+            {
+                const Slice &key = request.keys[0];
+                backend_.set(ServerKey(key.data, key.size), request.flags, request.exptime, request.data.data, request.data.size);
+                if (!request.noreply)
+                    appendConst("STORED\r\n");
+                break;
+            }
+            case MemcacheCommand::Delete:
+            {
+                const Slice &key = request.keys[0];
+                bool deleted = backend_.remove(ServerKey(key.data, key.size));
+                if (!request.noreply)
+                    appendConst(deleted ? "DELETED\r\n" : "NOT_FOUND\r\n");
+                break;
+            }
+            case MemcacheCommand::Version:
+                appendConst("VERSION MyCache-1.0\r\n");
+                break;
+            case MemcacheCommand::Quit:
+                closing_ = true;
+                break;
+            }
+        }
+
+        void appendConst(const char *text)
+        {
+            segments_.push_back(Segment{text, 0, std::strlen(text)});
+        }
+
+        // 读缓冲区满时先挪掉已处理的字节，仍然放不下一个请求时扩容
+        void makeRoom()
+        {
+            if (readBegin_ > 0)
+            {
+                std::memmove(readBuffer_.data(), readBuffer_.data() + readBegin_, readEnd_ - readBegin_);
+                readEnd_ -= readBegin_;
+                readBegin_ = 0;
+            }
+            if (readEnd_ == readBuffer_.size())
+                readBuffer_.resize(readBuffer_.size() * 2);
+        }
+
+        // 返回false表示写出错，连接应关闭
+        bool flush()
+        {
+            struct iovec iov[kMaxIov];
+            while (writeIndex_ < segments_.size())
+            {
+                int count = 0;
+                for (size_t i = writeIndex_; i < segments_.size() && count < static_cast<int>(kMaxIov); ++i, ++count)
+                {
+                    const Segment &segment = segments_[i];
+                    const char *data = segment.external ? segment.external : scratch_.data() + segment.offset;
+                    size_t skip = i == writeIndex_ ? writeOffset_ : 0;
+                    iov[count].iov_base = const_cast<char *>(data + skip);
+                    iov[count].iov_len = segment.size - skip;
+                }
+                ssize_t n = ::writev(fd_, iov, count);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        waitingWrite_ = true;
+                        return true;
+                    }
+                    return false;
+                }
+                size_t written = n;
+                while (written > 0)
+                {
+                    size_t remaining = segments_[writeIndex_].size - writeOffset_;
+                    if (written < remaining)
+                    {
+                        writeOffset_ += written;
+                        break;
+                    }
+                    written -= remaining;
+                    writeIndex_++;
+                    writeOffset_ = 0;
+                }
+            }
+            segments_.clear();
+            scratch_.clear();
+            pinned_.clear();
+            writeIndex_ = writeOffset_ = 0;
+            waitingWrite_ = false;
+            return true;
+        }
+
+        int fd_;
+        CacheBackend &backend_;
+        MemcacheParser &parser_;
+        MemcacheRequest request_;
+        std::vector<char> readBuffer_;
+        size_t readBegin_;
+        size_t readEnd_;
+        size_t skipBytes_; // 超长set数据块还需跳过的字节数
+        std::string scratch_;
+        std::vector<Segment> segments_;
+        std::vector<ServerItemPtr> pinned_; // 回复引用的条目，写完后释放
+        size_t writeIndex_;
+        size_t writeOffset_;
+        bool closing_;
+        bool waitingWrite_;
+    };
+
+    /* 每个线程一个事件循环：各自用SO_REUSEPORT绑定同一个端口，由内核把新连接分散到各个循环，
+       连接从接入到关闭都只在一个线程中处理，循环之间不共享任何状态(缓存后端除外)。 */
+    class EventLoop
+    {
+    public:
+        EventLoop(CacheBackend &backend, size_t maxItemSize) : backend_(backend), parser_(maxItemSize), listenFd_(-1), epollFd_(-1), wakeFd_(-1) {}
+
+        ~EventLoop()
+        {
+            connections_.clear();
+            if (listenFd_ >= 0)
+                ::close(listenFd_);
+            if (wakeFd_ >= 0)
+                ::close(wakeFd_);
+            if (epollFd_ >= 0)
+                ::close(epollFd_);
+        }
+
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        // 创建监听socket和epoll实例，失败时返回false并保留errno
+        bool listen(const std::string &host, int port)
+        {
+            listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listenFd_ < 0)
+                return false;
+            int on = 1;
+            ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if (::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+                return false;
+            sockaddr_in addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+            {
+                errno = EINVAL;
+                return false;
+            }
+            if (::bind(listenFd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(listenFd_, SOMAXCONN) < 0)
+                return false;
+
+            epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+            wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epollFd_ < 0 || wakeFd_ < 0)
+                return false;
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = &listenFd_;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+            event.data.ptr = &wakeFd_;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+            return true;
+        }
+
+        // 阻塞运行直到stop()
+        void run()
+        {
+            const int kMaxEvents = 256;
+            epoll_event events[kMaxEvents];
+            while (true)
+            {
+                int n = ::epoll_wait(epollFd_, events, kMaxEvents, -1);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return;
+                }
+                for (int i = 0; i < n; ++i)
+                {
+                    void *tag = events[i].data.ptr;
+                    if (tag == &wakeFd_)
+                        return;
+                    if (tag == &listenFd_)
+                    {
+                        acceptAll();
+                        continue;
+                    }
+                    auto *connection = static_cast<MemcacheConnection *>(tag);
+                    bool keep;
+                    if (events[i].events & (EPOLLERR | EPOLLHUP))
+                        keep = false;
+                    else if (events[i].events & EPOLLOUT)
+                        keep = connection->onWritable();
+                    else
+                        keep = connection->onReadable();
+                    if (keep)
+                        updateInterest(connection);
+                    else
+                        close(connection);
+                }
+            }
+        }
+
+        // 可在任意线程调用
+        void stop()
+        {
+            uint64_t one = 1;
+            ssize_t ignored = ::write(wakeFd_, &one, sizeof(one));
+            (void)ignored;
+        }
+
+        size_t connectionCount() const { return connections_.size(); }
+
+    private:
+        void acceptAll()
+        {
+            while (true)
+            {
+                int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                    return; // EAGAIN或连接数达到上限，等下次事件再试
+                int on = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                std::unique_ptr<MemcacheConnection> connection(new MemcacheConnection(fd, backend_, parser_));
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.ptr = connection.get();
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) == 0)
+                    connections_.emplace(fd, std::move(connection));
+            }
+        }
+
+        // 有回复没写完时只等可写，不再读新请求，避免回复无限堆积
+        void updateInterest(MemcacheConnection *connection)
+        {
+            epoll_event event;
+            event.events = connection->waitingWrite() ? EPOLLOUT : EPOLLIN;
+            event.data.ptr = connection;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection->fd(), &event);
+        }
+
+        void close(MemcacheConnection *connection)
+        {
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection->fd(), nullptr);
+            connections_.erase(connection->fd());
+        }
+
+        CacheBackend &backend_;
+        MemcacheParser parser_; // 同一循环中的连接轮流使用
+        int listenFd_;
+        int epollFd_;
+        int wakeFd_;
+        std::unordered_map<int, std::unique_ptr<MemcacheConnection>> connections_;
+    };
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace MyCache
+{
+    // 指向读缓冲区的一段字节，不拥有内存
+    struct Slice
+    {
+        const char *data;
+        size_t size;
+    };
+
+    enum class MemcacheCommand
+    {
+        Get,
+        Gets,
+        Set,
+        Delete,
+        Version,
+        Quit
+    };
+
+    struct MemcacheRequest
+    {
+        MemcacheCommand command;
+        std::vector<Slice> keys; // get/gets可以有多个key，set/delete只有一个
+        uint32_t flags;
+        int64_t exptime;
+        size_t bytes;
+        bool noreply;
+        Slice data;          // set的数据块，不含结尾的\r\n
+        const char *error;   // 解析失败时返回给客户端的完整错误行
+    };
+
+    /* memcached文本协议解析器，只支持get/gets/set/delete/version/quit。
+       请求直接在读缓冲区上解析，key和数据块都以Slice指向缓冲区，不做拷贝；
+       调用方在处理完请求、丢弃对应字节之前不能改动缓冲区。 */
+    class MemcacheParser
+    {
+    public:
+        enum class Result
+        {
+            Ok,       // 解析出一个完整请求，consumed为它占用的字节数
+            NeedMore, // 请求还不完整
+            Error,    // 请求格式错误，consumed为要丢弃的命令行长度，返回request.error
+            TooLarge, // set的数据块超过上限，回复request.error后还要跳过bytes + 2个字节
+            Fatal     // 命令行超长(get/gets为kMaxGetLineLength，其他为kMaxLineLength)，无法找到下一个请求的开头，回复request.error后关闭连接
+        };
+
+        static constexpr size_t kMaxKeyLength = 250;
+        static constexpr size_t kMaxLineLength = 2048;
+        // 多key的get/gets命令行可以很长，和memcached一样放宽上限，不因TCP分段的位置不同而时好时坏
+        static constexpr size_t kMaxGetLineLength = 1 << 20;
+
+        explicit MemcacheParser(size_t maxItemSize = 1 << 20) : maxItemSize_(maxItemSize) {}
+
+        Result parse(const char *begin, const char *end, MemcacheRequest &request, size_t &consumed)
+        {
+            const char *lineEnd = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+            if (!lineEnd)
+            {
+                size_t pending = end - begin;
+                if (pending <= kMaxLineLength || (pending <= kMaxGetLineLength && isGetLine(begin, end)))
+                    return Result::NeedMore;
+                fail(request, consumed, end - begin, "CLIENT_ERROR line too long\r\n");
+                return Result::Fatal;
+            }
+            size_t lineSize = lineEnd + 1 - begin;
+            const char *textEnd = lineEnd > begin && lineEnd[-1] == '\r' ? lineEnd - 1 : lineEnd;
+
+            tokens_.clear();
+            for (const char *p = begin; p < textEnd;)
+            {
+                while (p < textEnd && *p == ' ')
+                    p++;
+                const char *start = p;
+                while (p < textEnd && *p != ' ')
+                    p++;
+                if (p > start)
+                    tokens_.push_back(Slice{start, static_cast<size_t>(p - start)});
+            }
+            if (tokens_.empty())
+                return fail(request, consumed, lineSize, "ERROR\r\n");
+
+            request.keys.clear();
+            request.noreply = false;
+            const Slice &name = tokens_[0];
+            if (equals(name, "get") || equals(name, "gets"))
+            {
+                request.command = name.size == 3 ? MemcacheCommand::Get : MemcacheCommand::Gets;
+                if (tokens_.size() < 2)
+                    return fail(request, consumed, lineSize, "ERROR\r\n");
+                for (size_t i = 1; i < tokens_.size(); ++i)
+                {
+                    if (tokens_[i].size > kMaxKeyLength)
+                        return fail(request, consumed, lineSize, "CLIENT_ERROR bad command line format\r\n");
+                    request.keys.push_back(tokens_[i]);
+                }
+            }
+            else if (equals(name, "set"))
+            {
+                return parseSet(begin, end, lineSize, request, consumed);
+            }
+            else if (equals(name, "delete"))
+            {
+                request.command = MemcacheCommand::Delete;
+                if (tokens_.size() < 2 || tokens_.size() > 3 || tokens_[1].size > kMaxKeyLength)
+                    return fail(request, consumed, lineSize, "CLIENT_ERROR bad command line format\r\n");
+                if (tokens_.size() == 3 && !(request.noreply = equals(tokens_[2], "noreply")))
+                    return fail(request, consumed, lineSize, "CLIENT_ERROR bad command line format\r\n");
+                request.keys.push_back(tokens_[1]);
+            }
+            else if (equals(name, "version"))
+            {
+                request.command = MemcacheCommand::Version;
+            }
+            else if (equals(name, "quit"))
+            {
+                request.command = MemcacheCommand::Quit;
+            }
+            else
+            {
+                return fail(request, consumed, lineSize, "ERROR\r\n");
+            }
+            consumed = lineSize;
+            return Result::Ok;
+        }
+
+    private:
+        // set <key> <flags> <exptime> <bytes> [noreply]\r\n<data>\r\n
+        Result parseSet(const char *begin, const char *end, size_t lineSize, MemcacheRequest &request, size_t &consumed)
+        {
+            request.command = MemcacheCommand::Set;
+            uint64_t flags, bytes;
+            int64_t exptime;
+            if (tokens_.size() < 5 || tokens_.size() > 6 || tokens_[1].size > kMaxKeyLength ||
+                !parseUnsigned(tokens_[2], flags) || flags > UINT32_MAX ||
+                !parseSigned(tokens_[3], exptime) || !parseUnsigned(tokens_[4], bytes))
+                return fail(request, consumed, lineSize, "CLIENT_ERROR bad command line format\r\n");
+            if (tokens_.size() == 6 && !(request.noreply = equals(tokens_[5], "noreply")))
+                return fail(request, consumed, lineSize, "CLIENT_ERROR bad command line format\r\n");
+            request.keys.push_back(tokens_[1]);
+            request.flags = static_cast<uint32_t>(flags);
+            request.exptime = exptime;
+            request.bytes = bytes;
+            if (bytes > maxItemSize_)
+            {
+                request.error = "SERVER_ERROR object too large for cache\r\n";
+                consumed = lineSize;
+                return Result::TooLarge;
+            }
+            if (static_cast<size_t>(end - begin) < lineSize + bytes + 2)
+                return Result::NeedMore;
+            const char *data = begin + lineSize;
+            if (data[bytes] != '\r' || data[bytes + 1] != '\n')
+                return fail(request, consumed, lineSize, "CLIENT_ERROR bad data chunk\r\n");
+            request.data = Slice{data, bytes};
+            consumed = lineSize + bytes + 2;
+            return Result::Ok;
+        }
+
+        static Result fail(MemcacheRequest &request, size_t &consumed, size_t size, const char *error)
+        {
+            request.error = error;
+            consumed = size;
+            return Result::Error;
+        }
+
+        static bool equals(const Slice &token, const char *text)
+        {
+            size_t length = std::strlen(text);
+            return token.size == length && std::memcmp(token.data, text, length) == 0;
+        }
+
+        // 还没收完的命令行是否以get/gets开头(命令名之后已有空格)
+        static bool isGetLine(const char *begin, const char *end)
+        {
+            while (begin < end && *begin == ' ')
+                begin++;
+            const char *p = begin;
+            while (p < end && *p != ' ')
+                p++;
+            Slice name{begin, static_cast<size_t>(p - begin)};
+            return p < end && (equals(name, "get") || equals(name, "gets"));
+        }
+
+        static bool parseUnsigned(const Slice &token, uint64_t &value)
+        {
+            if (token.size == 0 || token.size > 20)
+                return false;
+            value = 0;
+            for (size_t i = 0; i < token.size; ++i)
+            {
+                char c = token.data[i];
+                if (c < '0' || c > '9')
+                    return false;
+                uint64_t digit = c - '0';
+                if (value > (UINT64_MAX - digit) / 10)
+                    return false;
+                value = value * 10 + digit;
+            }
+            return true;
+        }
+
+        static bool parseSigned(const Slice &token, int64_t &value)
+        {
+            bool negative = token.size > 0 && token.data[0] == '-';
+            uint64_t magnitude;
+            if (!parseUnsigned(Slice{token.data + negative, token.size - negative}, magnitude) || magnitude > INT64_MAX)
+                return false;
+            value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+            return true;
+        }
+
+        size_t maxItemSize_;
+        std::vector<Slice> tokens_; // 复用的分词结果，避免每个请求都分配
+    };
+}
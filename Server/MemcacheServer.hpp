@@ -0,0 +1,62 @@
+#pragma once
+
+#include "EventLoop.hpp"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MyCache
+{
+    // 多线程memcached文本协议服务：每个线程一个EventLoop，共享同一个缓存后端
+    class MemcacheServer
+    {
+    public:
+        MemcacheServer(std::unique_ptr<CacheBackend> backend, size_t maxItemSize = 1 << 20)
+            : backend_(std::move(backend)), maxItemSize_(maxItemSize)
+        {
+        }
+
+        ~MemcacheServer() { stop(); }
+
+        // 在host:port上启动threadNum个事件循环，threadNum为0时取CPU核数；失败时返回false并保留errno
+        bool start(const std::string &host, int port, int threadNum)
+        {
+            if (threadNum <= 0)
+                threadNum = std::max(1u, std::thread::hardware_concurrency());
+            for (int i = 0; i < threadNum; ++i)
+            {
+                loops_.emplace_back(new EventLoop(*backend_, maxItemSize_));
+                if (!loops_.back()->listen(host, port))
+                {
+                    loops_.clear();
+                    return false;
+                }
+            }
+            for (auto &loop : loops_)
+            {
+                EventLoop *target = loop.get();
+                threads_.emplace_back([target]()
+                                      { target->run(); });
+            }
+            return true;
+        }
+
+        void stop()
+        {
+            for (auto &loop : loops_)
+                loop->stop();
+            for (auto &thread : threads_)
+                thread.join();
+            threads_.clear();
+            loops_.clear();
+        }
+
+    private:
+        std::unique_ptr<CacheBackend> backend_;
+        size_t maxItemSize_;
+        std::vector<std::unique_ptr<EventLoop>> loops_;
+        std::vector<std::thread> threads_;
+    };
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MyCache
+{
+    /* 在线未命中率曲线估计(SHARDS空间采样)：
+       - 按key的哈希值采样，哈希落在阈值以下的key的所有访问都被跟踪，其他key只付出一次哈希和比较的开销；
+       - 对采样的访问计算LRU栈距离(上次访问以来访问过的不同key数)，按1/采样率放大后计入直方图；
+       - 由直方图可以得到任意容量下LRU的命中率估计。
+       maxSamples>0时为固定内存的SHARDS：跟踪的key数超过上限后降低采样率，之后的样本按更大的权重计入直方图。
+       采样到的访问数与期望值(总访问数*采样率)的偏差计入距离为0的桶(SHARDS-adj)，修正热点key是否被采中带来的偏差；
+       总访问数用按线程分条的计数器统计，避免命中路径上的共享写。 */
+    template <typename Key>
+    class ShardsTracker
+    {
+    public:
+        static constexpr uint64_t kModulus = 1ULL << 24; // 采样空间大小
+
+        explicit ShardsTracker(double sampleRate = 0.01, size_t bucketWidth = 16, size_t maxDistance = 1 << 22, size_t maxSamples = 0)
+            : threshold_(static_cast<uint64_t>(std::min(1.0, std::max(sampleRate, 1.0 / kModulus)) * kModulus)),
+              bucketWidth_(bucketWidth > 0 ? bucketWidth : 1), maxSamples_(maxSamples), time_(0),
+              totalReferences_(0), expectedReferences_(0), foldedReferences_(0), weight_(1.0)
+        {
+            histogram_.resize(maxDistance / bucketWidth_ + 1, 0.0);
+            fenwick_.resize(1024, 0);
+        }
+
+        // 记录一次访问，未被采样的key在这里直接返回
+        void record(const Key &key)
+        {
+            Counter &counter = counters_[threadSlot() % kCounterNum];
+            counter.value.fetch_add(1, std::memory_order_relaxed);
+            uint64_t hashValue = mix(std::hash<Key>()(key));
+            if ((hashValue & (kModulus - 1)) >= threshold_.load(std::memory_order_relaxed))
+                return;
+            recordSampled(hashValue);
+        }
+
+        double sampleRate() const
+        {
+            return static_cast<double>(threshold_.load(std::memory_order_relaxed)) / kModulus;
+        }
+
+        size_t sampledKeys()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return lastAccess_.size();
+        }
+
+        // 估计容量为capacity的LRU缓存的命中率
+        double estimateHitRate(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            double expected = expectedReferences_ + (referenceCount() - foldedReferences_) * sampleRate() * weight_;
+            if (expected <= 0 || capacity == 0)
+                return 0.0;
+            double hits = expected - totalReferences_; // SHARDS-adj修正
+            size_t buckets = std::min(histogram_.size(), capacity / bucketWidth_);
+            for (size_t i = 0; i < buckets; i++)
+                hits += histogram_[i];
+            return std::min(1.0, std::max(0.0, hits / expected));
+        }
+
+        // 返回(容量, 未命中率)曲线
+        std::vector<std::pair<size_t, double>> missRatioCurve(const std::vector<size_t> &capacities)
+        {
+            std::vector<std::pair<size_t, double>> curve;
+            for (size_t capacity : capacities)
+                curve.emplace_back(capacity, 1.0 - estimateHitRate(capacity));
+            return curve;
+        }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::fill(histogram_.begin(), histogram_.end(), 0.0);
+            std::fill(fenwick_.begin(), fenwick_.end(), 0);
+            lastAccess_.clear();
+            samplesByThreshold_.clear();
+            time_ = 0;
+            totalReferences_ = 0;
+            expectedReferences_ = 0;
+            weight_ = 1.0;
+            foldedReferences_ = referenceCount();
+        }
+
+    private:
+        static constexpr size_t kCounterNum = 16;
+
+        struct alignas(64) Counter
+        {
+            std::atomic<uint64_t> value{0};
+        };
+
+        // 每个线程固定使用一个计数器槽位，线程数超过kCounterNum时多个线程共用一个槽位，因此用fetch_add累加
+        static size_t threadSlot()
+        {
+            static std::atomic<size_t> nextSlot(0);
+            thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed);
+            return slot;
+        }
+
+        uint64_t referenceCount() const
+        {
+            uint64_t sum = 0;
+            for (const auto &counter : counters_)
+                sum += counter.value.load(std::memory_order_relaxed);
+            return sum;
+        }
+
+        static uint64_t mix(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xFF51AFD7ED558CCDULL;
+            key ^= key >> 33;
+            key *= 0xC4CEB9FE1A85EC53ULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        void recordSampled(uint64_t hashValue)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            uint64_t threshold = threshold_.load(std::memory_order_relaxed);
+            if ((hashValue & (kModulus - 1)) >= threshold)
+                return; // 加锁期间采样率被降低
+
+            totalReferences_ += weight_;
+            auto it = lastAccess_.find(hashValue);
+            if (it == lastAccess_.end())
+            {
+                touch(hashValue);
+                samplesByThreshold_.emplace(hashValue & (kModulus - 1), hashValue);
+                if (maxSamples_ > 0 && lastAccess_.size() > maxSamples_)
+                    lowerThreshold();
+                return;
+            }
+
+            // 栈距离 = 上次访问之后被访问过的不同key数，按采样率放大到整个key空间
+            uint64_t previous = it->second;
+            long long distance = fenwickSum(time_) - fenwickSum(previous);
+            double scale = static_cast<double>(kModulus) / threshold;
+            size_t bucket = static_cast<size_t>(distance * scale) / bucketWidth_;
+            if (bucket < histogram_.size())
+                histogram_[bucket] += weight_;
+
+            fenwickAdd(previous, -1);
+            lastAccess_.erase(it);
+            touch(hashValue);
+        }
+
+        // 把key记为当前时间最近访问过
+        void touch(uint64_t hashValue)
+        {
+            if (time_ + 1 >= fenwick_.size())
+                compact();
+            time_++;
+            lastAccess_[hashValue] = time_;
+            fenwickAdd(time_, 1);
+        }
+
+        // 固定内存模式：把阈值降到当前最大的采样值，淘汰该值及以上的key
+        void lowerThreshold()
+        {
+            uint64_t oldThreshold = threshold_.load(std::memory_order_relaxed);
+            uint64_t references = referenceCount();
+            expectedReferences_ += (references - foldedReferences_) * (static_cast<double>(oldThreshold) / kModulus) * weight_;
+            foldedReferences_ = references;
+            uint64_t newThreshold = samplesByThreshold_.rbegin()->first;
+            while (!samplesByThreshold_.empty() && samplesByThreshold_.rbegin()->first >= newThreshold)
+            {
+                auto last = std::prev(samplesByThreshold_.end());
+                auto it = lastAccess_.find(last->second);
+                fenwickAdd(it->second, -1);
+                lastAccess_.erase(it);
+                samplesByThreshold_.erase(last);
+            }
+            threshold_.store(newThreshold, std::memory_order_relaxed);
+            // 采样率降低后，之后每个样本代表的访问数相应变多
+            weight_ *= static_cast<double>(oldThreshold) / newThreshold;
+        }
+
+        void fenwickAdd(uint64_t time, int delta)
+        {
+            for (size_t i = static_cast<size_t>(time); i < fenwick_.size(); i += i & (~i + 1))
+                fenwick_[i] += delta;
+        }
+
+        long long fenwickSum(uint64_t time) const
+        {
+            long long sum = 0;
+            for (size_t i = static_cast<size_t>(time); i > 0; i -= i & (~i + 1))
+                sum += fenwick_[i];
+            return sum;
+        }
+
+        // 时间戳用完时按最近访问顺序重新编号，树的大小保持为存活key数的两倍以上
+        void compact()
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> order; // (时间, key)
+            order.reserve(lastAccess_.size());
+            for (const auto &pair : lastAccess_)
+                order.emplace_back(pair.second, pair.first);
+            std::sort(order.begin(), order.end());
+            size_t size = 1024;
+            while (size < order.size() * 2 + 2)
+                size <<= 1;
+            fenwick_.assign(size, 0);
+            time_ = 0;
+            for (const auto &pair : order)
+            {
+                time_++;
+                lastAccess_[pair.second] = time_;
+                fenwickAdd(time_, 1);
+            }
+        }
+
+        std::atomic<uint64_t> threshold_; // 哈希值低位小于阈值的key被采样
+        size_t bucketWidth_;              // 直方图每个桶覆盖的栈距离
+        size_t maxSamples_;               // 固定内存模式下跟踪的key数上限
+        uint64_t time_;                   // 采样访问的逻辑时间
+        double totalReferences_;          // 采样访问次数
+        double expectedReferences_;       // 截至foldedReferences_时按采样率折算的期望采样访问次数
+        uint64_t foldedReferences_;       // 已折算进expectedReferences_的总访问数
+        double weight_;                   // 每个样本的权重，反比于当前采样率
+
+        Counter counters_[kCounterNum]; // 总访问数(含未采样的)
+
+        std::unordered_map<uint64_t, uint64_t> lastAccess_;  // key哈希 -> 上次访问时间
+        std::multimap<uint64_t, uint64_t> samplesByThreshold_; // 采样值 -> key哈希，用于降低采样率
+        std::vector<long long> fenwick_;                      // 每个时间点是否为某key的最近一次访问
+        std::vector<double> histogram_;                       // 放大后的栈距离直方图
+        std::mutex mutex_;
+    };
+}
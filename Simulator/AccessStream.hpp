@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MyCache
+{
+    // 访问序列：依次产生被访问的key，reset()后从头重新产生完全相同的序列
+    class AccessStream
+    {
+    public:
+        virtual ~AccessStream() {};
+
+        // 取下一个key，序列结束时返回false
+        virtual bool next(uint64_t &key) = 0;
+
+        // 回到序列开头
+        virtual void reset() = 0;
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../CachePolicy.h"
+#include "AccessStream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MyCache
+{
+    struct SimulationResult
+    {
+        std::string policy;
+        int capacity;
+        uint64_t accesses;
+        uint64_t misses;
+
+        double missRatio() const { return accesses == 0 ? 0.0 : static_cast<double>(misses) / accesses; }
+    };
+
+    /* 缓存模拟器：让每个策略在每个容量下回放同一条访问序列，得到未命中率曲线(MRC)。
+       访问语义为按需填充：get未命中即计一次未命中，并put进缓存。
+       各(策略, 容量)组合互相独立，由多个线程并行执行。 */
+    class CacheSimulator
+    {
+    public:
+        using Cache = CachePolicy<uint64_t, uint64_t>;
+        using PolicyFactory = std::function<std::unique_ptr<Cache>(int capacity)>;
+        using StreamFactory = std::function<std::unique_ptr<AccessStream>()>;
+
+        explicit CacheSimulator(int threadNum = 0)
+            : threadNum_(threadNum > 0 ? threadNum : std::max(1u, std::thread::hardware_concurrency())) {}
+
+        void addPolicy(const std::string &name, PolicyFactory factory)
+        {
+            policies_.push_back({name, std::move(factory)});
+        }
+
+        // makeStream每次调用需返回一条从头开始的相同序列
+        std::vector<SimulationResult> run(const StreamFactory &makeStream, const std::vector<int> &capacities) const
+        {
+            std::vector<SimulationResult> results;
+            for (const auto &policy : policies_)
+                for (int capacity : capacities)
+                    results.push_back({policy.name, capacity, 0, 0});
+
+            std::atomic<size_t> nextJob(0);
+            auto worker = [&]()
+            {
+                for (size_t job = nextJob++; job < results.size(); job = nextJob++)
+                {
+                    SimulationResult &result = results[job];
+                    const PolicyEntry &policy = policies_[job / capacities.size()];
+                    std::unique_ptr<Cache> cache = policy.factory(result.capacity);
+                    std::unique_ptr<AccessStream> stream = makeStream();
+                    uint64_t key, value;
+                    while (stream->next(key))
+                    {
+                        result.accesses++;
+                        if (!cache->get(key, value))
+                        {
+                            result.misses++;
+                            cache->put(key, key);
+                        }
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (int i = 1; i < threadNum_; i++)
+                threads.emplace_back(worker);
+            worker();
+            for (auto &thread : threads)
+                thread.join();
+            return results;
+        }
+
+        // 以表格打印未命中率曲线：每行一个容量，每列一个策略
+        static void printCurves(std::ostream &out, const std::vector<SimulationResult> &results)
+        {
+            std::vector<std::string> names;
+            std::vector<int> capacities;
+            for (const auto &result : results)
+            {
+                if (std::find(names.begin(), names.end(), result.policy) == names.end())
+                    names.push_back(result.policy);
+                if (std::find(capacities.begin(), capacities.end(), result.capacity) == capacities.end())
+                    capacities.push_back(result.capacity);
+            }
+            out << std::left << std::setw(10) << "容量";
+            for (const auto &name : names)
+                out << std::setw(12) << name;
+            out << std::endl;
+            for (int capacity : capacities)
+            {
+                out << std::setw(10) << capacity;
+                for (const auto &name : names)
+                {
+                    for (const auto &result : results)
+                    {
+                        if (result.policy == name && result.capacity == capacity)
+                            out << std::setw(12) << std::fixed << std::setprecision(4) << result.missRatio();
+                    }
+                }
+                out << std::endl;
+            }
+        }
+
+        // CSV格式：policy,capacity,accesses,misses,miss_ratio
+        static void writeCsv(std::ostream &out, const std::vector<SimulationResult> &results)
+        {
+            out << "policy,capacity,accesses,misses,miss_ratio" << std::endl;
+            for (const auto &result : results)
+            {
+                out << result.policy << "," << result.capacity << "," << result.accesses << ","
+                    << result.misses << "," << std::fixed << std::setprecision(6) << result.missRatio() << std::endl;
+            }
+        }
+
+    private:
+        struct PolicyEntry
+        {
+            std::string name;
+            PolicyFactory factory;
+        };
+
+        int threadNum_;
+        std::vector<PolicyEntry> policies_;
+    };
+}
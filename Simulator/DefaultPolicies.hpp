@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CacheSimulator.hpp"
+#include "../LruCache.hpp"
+#include "../LfuCache.hpp"
+#include "../SampledLfuCache.hpp"
+#include "../ArcCache/ArcCache.hpp"
+#include "../LirsCache.hpp"
+#include "../SlruCache.hpp"
+#include "../GdsfCache.hpp"
+
+namespace MyCache
+{
+    // 注册仓库中实现了CachePolicy的所有策略
+    inline void addDefaultPolicies(CacheSimulator &simulator)
+    {
+        using Cache = CacheSimulator::Cache;
+        simulator.addPolicy("LRU", [](int capacity)
+                            { return std::unique_ptr<Cache>(new LruCache<uint64_t, uint64_t>(capacity)); });
+        simulator.addPolicy("LFU", [](int capacity)
+                            { return std::unique_ptr<Cache>(new LfuCache<uint64_t, uint64_t>(capacity)); });
+        simulator.addPolicy("ARC", [](int capacity)
+                            { return std::unique_ptr<Cache>(new ArcCache<uint64_t, uint64_t>(capacity)); });
+        // 历史记录容量取缓存容量的两倍，k=2
+        simulator.addPolicy("LRU-K", [](int capacity)
+                            { return std::unique_ptr<Cache>(new LruKCache<uint64_t, uint64_t>(capacity, capacity * 2, 2)); });
+        simulator.addPolicy("SampledLFU", [](int capacity)
+                            { return std::unique_ptr<Cache>(new SampledLfuCache<uint64_t, uint64_t>(capacity)); });
+        simulator.addPolicy("LIRS", [](int capacity)
+                            { return std::unique_ptr<Cache>(new LirsCache<uint64_t, uint64_t>(capacity)); });
+        simulator.addPolicy("SLRU", [](int capacity)
+                            { return std::unique_ptr<Cache>(new SlruCache<uint64_t, uint64_t>(capacity)); });
+        simulator.addPolicy("2Q", [](int capacity)
+                            { return std::unique_ptr<Cache>(new TwoQueueCache<uint64_t, uint64_t>(capacity)); });
+        // 模拟器中每个条目大小和代价都为1，此时GDSF相当于带老化的LFU
+        simulator.addPolicy("GDSF", [](int capacity)
+                            { return std::unique_ptr<Cache>(new GdsfCache<uint64_t, uint64_t>(capacity)); });
+    }
+}
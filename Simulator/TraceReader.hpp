@@ -0,0 +1,208 @@
+#pragma once
+
+#include "AccessStream.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MYCACHE_HAVE_MMAP 1
+#endif
+
+namespace MyCache
+{
+    // 只读映射整个文件，不支持mmap的平台退化为一次性读入内存
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &path) : data_(nullptr), size_(0), mapped_(false)
+        {
+#ifdef MYCACHE_HAVE_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd >= 0)
+            {
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    void *addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr != MAP_FAILED)
+                    {
+                        ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+                        data_ = static_cast<const char *>(addr);
+                        size_ = st.st_size;
+                        mapped_ = true;
+                    }
+                }
+                ::close(fd);
+                if (mapped_)
+                    return;
+            }
+#endif
+            std::ifstream in(path, std::ios::binary);
+            buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+
+        ~MappedFile()
+        {
+#ifdef MYCACHE_HAVE_MMAP
+            if (mapped_)
+                ::munmap(const_cast<char *>(data_), size_);
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const char *data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const char *data_;
+        size_t size_;
+        bool mapped_;
+        std::vector<char> buffer_;
+    };
+
+    /* 访问轨迹回放，支持三种格式：
+       - Binary：连续的小端uint64 key；
+       - Arc：ARC论文轨迹，每行"起始块号 块数 忽略 请求号"，展开为连续的块号；
+       - Lirs：LIRS论文轨迹，每行一个块号，非数字行(如"*")被跳过。
+       文本直接在映射区上解析，不做额外拷贝。 */
+    class TraceReader : public AccessStream
+    {
+    public:
+        enum class Format
+        {
+            Binary,
+            Arc,
+            Lirs
+        };
+
+        TraceReader(const std::string &path, Format format) : file_(path), format_(format)
+        {
+            reset();
+        }
+
+        bool valid() const { return file_.size() > 0; }
+
+        bool next(uint64_t &key) override
+        {
+            if (pendingBlocks_ > 0)
+            {
+                key = nextBlock_++;
+                pendingBlocks_--;
+                return true;
+            }
+            switch (format_)
+            {
+            case Format::Binary:
+                return nextBinary(key);
+            case Format::Arc:
+                return nextArc(key);
+            default:
+                return nextLirs(key);
+            }
+        }
+
+        void reset() override
+        {
+            pos_ = 0;
+            pendingBlocks_ = 0;
+            nextBlock_ = 0;
+        }
+
+        static bool parseFormat(const std::string &name, Format &format)
+        {
+            if (name == "binary")
+                format = Format::Binary;
+            else if (name == "arc")
+                format = Format::Arc;
+            else if (name == "lirs")
+                format = Format::Lirs;
+            else
+                return false;
+            return true;
+        }
+
+    private:
+        bool nextBinary(uint64_t &key)
+        {
+            if (pos_ + sizeof(uint64_t) > file_.size())
+                return false;
+            const unsigned char *bytes = reinterpret_cast<const unsigned char *>(file_.data() + pos_);
+            key = 0;
+            for (int i = 7; i >= 0; i--)
+                key = (key << 8) | bytes[i];
+            pos_ += sizeof(uint64_t);
+            return true;
+        }
+
+        bool nextArc(uint64_t &key)
+        {
+            uint64_t numbers[4];
+            while (pos_ < file_.size())
+            {
+                int count = parseLine(numbers, 4);
+                if (count >= 2 && numbers[1] > 0)
+                {
+                    key = numbers[0];
+                    nextBlock_ = numbers[0] + 1;
+                    pendingBlocks_ = numbers[1] - 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool nextLirs(uint64_t &key)
+        {
+            while (pos_ < file_.size())
+            {
+                if (parseLine(&key, 1) == 1)
+                    return true;
+            }
+            return false;
+        }
+
+        // 解析当前行开头的若干个非负整数，遇到非数字字段即停止，并跳到下一行
+        int parseLine(uint64_t *numbers, int maxCount)
+        {
+            const char *data = file_.data();
+            size_t size = file_.size();
+            int count = 0;
+            while (pos_ < size && data[pos_] != '\n')
+            {
+                char c = data[pos_];
+                if (c == ' ' || c == '\t' || c == '\r' || c == ',')
+                {
+                    pos_++;
+                    continue;
+                }
+                if (c < '0' || c > '9' || count == maxCount)
+                    break;
+                uint64_t value = 0;
+                while (pos_ < size && data[pos_] >= '0' && data[pos_] <= '9')
+                    value = value * 10 + (data[pos_++] - '0');
+                numbers[count++] = value;
+            }
+            while (pos_ < size && data[pos_] != '\n')
+                pos_++;
+            pos_++; // 跳过换行符
+            return count;
+        }
+
+        MappedFile file_;
+        Format format_;
+        size_t pos_;
+        uint64_t pendingBlocks_; // Arc格式中当前请求尚未产生的块数
+        uint64_t nextBlock_;
+    };
+}
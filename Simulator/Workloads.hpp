@@ -0,0 +1,232 @@
+#pragma once
+
+#include "AccessStream.hpp"
+#include "../HashMix.h"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace MyCache
+{
+    /* Zipf分布：排名为k的key被访问的概率正比于1/k^skew，skew越大越集中。
+       采用Hörmann-Derflinger的拒绝-逆变换采样，O(1)时间且不需要预先计算整张概率表。
+       scramble为true时把排名打散到整个key空间，避免热点key在哈希上相邻。 */
+    class ZipfGenerator : public AccessStream
+    {
+    public:
+        ZipfGenerator(uint64_t keyNum, double skew, uint64_t count, uint64_t seed = 1, bool scramble = false)
+            : keyNum_(keyNum > 0 ? keyNum : 1), skew_(skew), count_(count), seed_(seed), scramble_(scramble)
+        {
+            hIntegralX1_ = hIntegral(1.5) - 1.0;
+            hIntegralNum_ = hIntegral(keyNum_ + 0.5);
+            sDiv_ = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+            reset();
+        }
+
+        bool next(uint64_t &key) override
+        {
+            if (produced_ >= count_)
+                return false;
+            produced_++;
+            uint64_t rank = sample();
+            key = scramble_ ? mixKey(rank) : rank - 1;
+            return true;
+        }
+
+        void reset() override
+        {
+            gen_.seed(seed_);
+            produced_ = 0;
+        }
+
+    private:
+        uint64_t sample()
+        {
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            while (true)
+            {
+                double u = hIntegralNum_ + uniform(gen_) * (hIntegralX1_ - hIntegralNum_);
+                double x = hIntegralInverse(u);
+                double k = std::floor(x + 0.5);
+                if (k < 1)
+                    k = 1;
+                else if (k > keyNum_)
+                    k = static_cast<double>(keyNum_);
+                if (k - x <= sDiv_ || u >= hIntegral(k + 0.5) - h(k))
+                    return static_cast<uint64_t>(k);
+            }
+        }
+
+        double h(double x) const { return std::exp(-skew_ * std::log(x)); }
+
+        double hIntegral(double x) const
+        {
+            double logX = std::log(x);
+            return helper2((1.0 - skew_) * logX) * logX;
+        }
+
+        double hIntegralInverse(double x) const
+        {
+            double t = x * (1.0 - skew_);
+            if (t < -1.0)
+                t = -1.0;
+            return std::exp(helper1(t) * x);
+        }
+
+        // log(1+x)/x，x接近0时用泰勒展开
+        static double helper1(double x)
+        {
+            return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+
+        // (exp(x)-1)/x，x接近0时用泰勒展开
+        static double helper2(double x)
+        {
+            return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+        }
+
+        uint64_t keyNum_;
+        double skew_;
+        uint64_t count_;
+        uint64_t seed_;
+        bool scramble_;
+        uint64_t produced_;
+        double hIntegralX1_;
+        double hIntegralNum_;
+        double sDiv_;
+        std::mt19937_64 gen_;
+    };
+
+    // 均匀随机访问[offset, offset+keyNum)
+    class UniformGenerator : public AccessStream
+    {
+    public:
+        UniformGenerator(uint64_t keyNum, uint64_t count, uint64_t seed = 1, uint64_t offset = 0)
+            : keyNum_(keyNum > 0 ? keyNum : 1), count_(count), seed_(seed), offset_(offset)
+        {
+            reset();
+        }
+
+        bool next(uint64_t &key) override
+        {
+            if (produced_ >= count_)
+                return false;
+            produced_++;
+            key = offset_ + gen_() % keyNum_;
+            return true;
+        }
+
+        void reset() override
+        {
+            gen_.seed(seed_);
+            produced_ = 0;
+        }
+
+    private:
+        uint64_t keyNum_;
+        uint64_t count_;
+        uint64_t seed_;
+        uint64_t offset_;
+        uint64_t produced_;
+        std::mt19937_64 gen_;
+    };
+
+    // 循环顺序扫描[offset, offset+loopSize)
+    class LoopGenerator : public AccessStream
+    {
+    public:
+        LoopGenerator(uint64_t loopSize, uint64_t count, uint64_t offset = 0)
+            : loopSize_(loopSize > 0 ? loopSize : 1), count_(count), offset_(offset), produced_(0) {}
+
+        bool next(uint64_t &key) override
+        {
+            if (produced_ >= count_)
+                return false;
+            key = offset_ + produced_ % loopSize_;
+            produced_++;
+            return true;
+        }
+
+        void reset() override { produced_ = 0; }
+
+    private:
+        uint64_t loopSize_;
+        uint64_t count_;
+        uint64_t offset_;
+        uint64_t produced_;
+    };
+
+    // 热点/冷数据混合：hotPercent%的访问落在hotKeys个热点上，其余落在coldKeys个冷数据上
+    class HotColdGenerator : public AccessStream
+    {
+    public:
+        HotColdGenerator(uint64_t hotKeys, uint64_t coldKeys, int hotPercent, uint64_t count, uint64_t seed = 1)
+            : hotKeys_(hotKeys > 0 ? hotKeys : 1), coldKeys_(coldKeys > 0 ? coldKeys : 1), hotPercent_(hotPercent),
+              count_(count), seed_(seed)
+        {
+            reset();
+        }
+
+        bool next(uint64_t &key) override
+        {
+            if (produced_ >= count_)
+                return false;
+            produced_++;
+            if (static_cast<int>(gen_() % 100) < hotPercent_)
+                key = gen_() % hotKeys_;
+            else
+                key = hotKeys_ + gen_() % coldKeys_;
+            return true;
+        }
+
+        void reset() override
+        {
+            gen_.seed(seed_);
+            produced_ = 0;
+        }
+
+    private:
+        uint64_t hotKeys_;
+        uint64_t coldKeys_;
+        int hotPercent_;
+        uint64_t count_;
+        uint64_t seed_;
+        uint64_t produced_;
+        std::mt19937_64 gen_;
+    };
+
+    // 工作负载切换：依次播放多个阶段的访问序列
+    class PhasedWorkload : public AccessStream
+    {
+    public:
+        PhasedWorkload &addPhase(std::unique_ptr<AccessStream> phase)
+        {
+            phases_.push_back(std::move(phase));
+            return *this;
+        }
+
+        bool next(uint64_t &key) override
+        {
+            while (current_ < phases_.size())
+            {
+                if (phases_[current_]->next(key))
+                    return true;
+                current_++;
+            }
+            return false;
+        }
+
+        void reset() override
+        {
+            for (auto &phase : phases_)
+                phase->reset();
+            current_ = 0;
+        }
+
+    private:
+        std::vector<std::unique_ptr<AccessStream>> phases_;
+        size_t current_ = 0;
+    };
+}
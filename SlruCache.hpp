@@ -0,0 +1,359 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+namespace MyCache
+{
+    // 分段缓存共用的侵入式双向链表，头部最新，尾部为淘汰候选；节点需要prev/next成员
+    template <typename Node>
+    class SegmentList
+    {
+    public:
+        void pushFront(Node *node)
+        {
+            node->prev = nullptr;
+            node->next = head_;
+            if (head_)
+                head_->prev = node;
+            else
+                tail_ = node;
+            head_ = node;
+            size_++;
+        }
+
+        void unlink(Node *node)
+        {
+            if (node->prev)
+                node->prev->next = node->next;
+            else
+                head_ = node->next;
+            if (node->next)
+                node->next->prev = node->prev;
+            else
+                tail_ = node->prev;
+            node->prev = node->next = nullptr;
+            size_--;
+        }
+
+        void moveToFront(Node *node)
+        {
+            if (node == head_)
+                return;
+            unlink(node);
+            pushFront(node);
+        }
+
+        Node *back() const { return tail_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+    private:
+        Node *head_ = nullptr;
+        Node *tail_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    /* 分段LRU(SLRU)：新条目进入试用段，在试用段中再次被访问才晋升到保护段；
+       保护段超出容量时把最久未访问的条目降回试用段头部，淘汰总是先从试用段尾部开始。
+       只被访问一次的扫描数据停留在试用段，不会冲掉保护段中的热点数据。
+       两段共用一个哈希表和一种节点，一次操作只加一次锁。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class SlruCache : public CachePolicy<Key, Value>
+    {
+    public:
+        // protectedRatio为保护段占总容量的比例
+        explicit SlruCache(int capacity, double protectedRatio = 0.8)
+            : capacity_(std::max(capacity, 0)),
+              protectedCapacity_(static_cast<size_t>(std::max(0.0, std::floor(capacity_ * protectedRatio))))
+        {
+            if (protectedCapacity_ >= static_cast<size_t>(capacity_) && capacity_ > 0)
+                protectedCapacity_ = capacity_ - 1; // 至少给试用段留一个位置
+            nodeMap_.reserve(capacity_);
+        }
+
+        ~SlruCache() override
+        {
+            for (auto &item : nodeMap_)
+                delete item.second;
+        }
+
+        void put(Key key, Value value) override
+        {
+            if (capacity_ <= 0)
+                return;
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end())
+            {
+                it->second->value = value;
+                access(it->second);
+                return;
+            }
+            if (nodeMap_.size() >= static_cast<size_t>(capacity_))
+                evict();
+            Node *node = new Node(key, value);
+            nodeMap_.emplace(key, node);
+            probation_.pushFront(node);
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end())
+                return false;
+            access(it->second);
+            value = it->second->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end())
+                return;
+            Node *node = it->second;
+            segment(node).unlink(node);
+            nodeMap_.erase(it);
+            delete node;
+        }
+
+        size_t size()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return nodeMap_.size();
+        }
+
+        // 保护段中的条目数
+        size_t protectedSize()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return protected_.size();
+        }
+
+    private:
+        struct Node
+        {
+            Node(const Key &key, const Value &value) : isProtected(false), key(key), value(value) {}
+
+            Node *prev = nullptr;
+            Node *next = nullptr;
+            bool isProtected;
+            Key key;
+            Value value;
+        };
+
+        SegmentList<Node> &segment(Node *node) { return node->isProtected ? protected_ : probation_; }
+
+        void access(Node *node)
+        {
+            if (node->isProtected)
+            {
+                protected_.moveToFront(node);
+                return;
+            }
+            if (protectedCapacity_ == 0)
+            {
+                probation_.moveToFront(node);
+                return;
+            }
+            // 晋升到保护段，保护段满时降级最久未访问的条目
+            probation_.unlink(node);
+            node->isProtected = true;
+            protected_.pushFront(node);
+            if (protected_.size() > protectedCapacity_)
+            {
+                Node *demoted = protected_.back();
+                protected_.unlink(demoted);
+                demoted->isProtected = false;
+                probation_.pushFront(demoted);
+            }
+        }
+
+        void evict()
+        {
+            Node *victim = probation_.empty() ? protected_.back() : probation_.back();
+            segment(victim).unlink(victim);
+            nodeMap_.erase(victim->key);
+            delete victim;
+        }
+
+        int capacity_;
+        size_t protectedCapacity_;
+        SegmentList<Node> probation_;
+        SegmentList<Node> protected_;
+        std::unordered_map<Key, Node *> nodeMap_;
+        Lock mutex_;
+    };
+
+    /* 2Q(完整版)：A1in是新条目的FIFO，A1out只记录从A1in淘汰的key(幽灵条目，不保存value)，Am是LRU。
+       - 新key进入A1in，在A1in中被再次访问不改变顺序；
+       - A1in超过inRatio时从A1in尾部淘汰并记入A1out，否则从Am尾部淘汰；
+       - put命中A1out的key说明它在短时间内被再次使用，直接进入Am。
+       A1out最多保留capacity*outRatio个key。与SLRU一样只有一个哈希表和一种节点。 */
+    template <typename Key, typename Value, typename Lock = std::mutex>
+    class TwoQueueCache : public CachePolicy<Key, Value>
+    {
+    public:
+        explicit TwoQueueCache(int capacity, double inRatio = 0.25, double outRatio = 0.5)
+            : capacity_(std::max(capacity, 0)), residentCount_(0),
+              inCapacity_(static_cast<size_t>(std::max(1.0, std::round(capacity_ * inRatio)))),
+              outCapacity_(static_cast<size_t>(std::max(1.0, std::round(capacity_ * outRatio))))
+        {
+        }
+
+        ~TwoQueueCache() override
+        {
+            for (auto &item : nodeMap_)
+                delete item.second;
+        }
+
+        void put(Key key, Value value) override
+        {
+            if (capacity_ <= 0)
+                return;
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end() && it->second->queue != Ghost)
+            {
+                it->second->value = value;
+                access(it->second);
+                return;
+            }
+            Node *ghost = it != nodeMap_.end() ? it->second : nullptr;
+            if (residentCount_ >= static_cast<size_t>(capacity_))
+                reclaim(ghost);
+            residentCount_++;
+            if (ghost)
+            {
+                a1out_.unlink(ghost);
+                ghost->value = value;
+                ghost->queue = Main;
+                am_.pushFront(ghost);
+                return;
+            }
+            Node *node = new Node(key, value);
+            nodeMap_.emplace(key, node);
+            a1in_.pushFront(node);
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end() || it->second->queue == Ghost)
+                return false;
+            access(it->second);
+            value = it->second->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key)
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            auto it = nodeMap_.find(key);
+            if (it == nodeMap_.end())
+                return;
+            Node *node = it->second;
+            if (node->queue != Ghost)
+                residentCount_--;
+            queue(node).unlink(node);
+            nodeMap_.erase(it);
+            delete node;
+        }
+
+        size_t size()
+        {
+            std::lock_guard<Lock> lock(mutex_);
+            return residentCount_;
+        }
+
+    private:
+        enum QueueId
+        {
+            In,
+            Ghost,
+            Main
+        };
+
+        struct Node
+        {
+            Node(const Key &key, const Value &value) : queue(In), key(key), value(value) {}
+
+            Node *prev = nullptr;
+            Node *next = nullptr;
+            QueueId queue;
+            Key key;
+            Value value;
+        };
+
+        SegmentList<Node> &queue(Node *node)
+        {
+            return node->queue == In ? a1in_ : (node->queue == Ghost ? a1out_ : am_);
+        }
+
+        void access(Node *node)
+        {
+            if (node->queue == Main)
+                am_.moveToFront(node);
+        }
+
+        // 腾出一个常驻位置，keep为正在复活的幽灵条目，不能被裁掉
+        void reclaim(Node *keep)
+        {
+            if (a1in_.size() > inCapacity_ || am_.empty())
+            {
+                Node *victim = a1in_.back();
+                a1in_.unlink(victim);
+                victim->queue = Ghost;
+                victim->value = Value{};
+                a1out_.pushFront(victim);
+                residentCount_--;
+                while (a1out_.size() > outCapacity_)
+                {
+                    Node *oldest = a1out_.back();
+                    if (oldest == keep)
+                        break;
+                    a1out_.unlink(oldest);
+                    nodeMap_.erase(oldest->key);
+                    delete oldest;
+                }
+                return;
+            }
+            Node *victim = am_.back();
+            am_.unlink(victim);
+            nodeMap_.erase(victim->key);
+            delete victim;
+            residentCount_--;
+        }
+
+        int capacity_;
+        size_t residentCount_;
+        size_t inCapacity_;
+        size_t outCapacity_;
+        SegmentList<Node> a1in_;  // 新条目，FIFO
+        SegmentList<Node> a1out_; // 幽灵条目，FIFO
+        SegmentList<Node> am_;    // 热条目，LRU
+        std::unordered_map<Key, Node *> nodeMap_;
+        Lock mutex_;
+    };
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "MaintenanceExecutor.hpp"
+#include "NodeLayout.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace MyCache
+{
+    /* 读多写少场景下的LFU：
+       - 读写锁按条带(stripe)拆分，读线程只对自己条带加共享锁，互不争用同一把锁；
+       - 命中时只对节点做一次relaxed原子自增记录访问频次，并把节点登记到条带的读缓冲区；
+       - 频次链表的迁移、最小频次维护和老化都推迟到持有全部条带写锁的批量维护步骤中完成。
+       写操作(put)需要按顺序获取所有条带的写锁，因此适合读占绝大多数的负载。 */
+    template <typename Key, typename Value>
+    class StripedLfuCache : public CachePolicy<Key, Value>
+    {
+    private:
+        struct Node;
+        using NodePtr = std::shared_ptr<Node>;
+        using FreqList = std::list<Node *>;
+        using FreqMap = std::map<int, FreqList>;
+        using NodeMap = std::unordered_map<Key, NodePtr>;
+
+        struct Node
+        {
+            // 热字段：命中路径和迁移时读写的频次信息放在最前面
+            int freq;                      // 已生效的访问频次
+            std::atomic<int> pendingFreq;  // 尚未迁移的命中次数
+            typename FreqList::iterator pos; // 在频次链表中的位置
+            // 冷字段
+            Key key;
+            Value value;
+
+            Node(Key key, Value value) : freq(1), pendingFreq(0), key(key), value(value) {}
+
+            static_assert(fitsSharedNodeLine(sizeof(int) + sizeof(std::atomic<int>) + sizeof(typename FreqList::iterator)), "StripedLfu节点热字段超出一个缓存行");
+        };
+
+        static constexpr size_t kReadBufferSize = 64;       // 每个条带读缓冲区大小
+        static constexpr size_t kDrainThreshold = kReadBufferSize / 2; // 达到后尝试非阻塞维护
+
+        struct alignas(kCacheLineSize) Stripe
+        {
+            std::shared_timed_mutex mutex;
+            std::atomic<size_t> writeIdx{0};
+            std::array<std::atomic<Node *>, kReadBufferSize> buffer;
+        };
+
+    public:
+        explicit StripedLfuCache(int capacity, int stripeNum = 0, int maxAverageNum = 1000000)
+            : capacity_(capacity), stripeNum_(stripeNum > 0 ? stripeNum : std::thread::hardware_concurrency()),
+              maxAverageNum_(maxAverageNum), curAverageNum_(0), curTotalNum_(0), drainScheduled_(false)
+        {
+            if (stripeNum_ <= 0)
+                stripeNum_ = 1;
+            stripes_ = std::vector<Stripe, CacheLineAllocator<Stripe>>(stripeNum_);
+        }
+
+        ~StripedLfuCache() override = default;
+
+        void put(Key key, Value value) override
+        {
+            if (capacity_ <= 0)
+                return;
+            lockAll();
+            drainReadBuffers();
+            auto it = nodeMap_.find(key);
+            if (it != nodeMap_.end())
+            {
+                it->second->value = value;
+                it->second->pendingFreq.fetch_add(1, std::memory_order_relaxed);
+                applyPending(it->second.get());
+            }
+            else
+            {
+                putInternal(key, value);
+            }
+            unlockAll();
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            Stripe &stripe = stripes_[currentStripe()];
+            NodePtr pinned; // 读缓冲区满时持有节点，防止在拿到写锁前被淘汰
+            bool found = false;
+            size_t idx = 0;
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(stripe.mutex);
+                auto it = nodeMap_.find(key);
+                if (it == nodeMap_.end())
+                    return false;
+                Node *node = it->second.get();
+                value = node->value;
+                found = true;
+                // 只有第一次待迁移的命中才需要登记到读缓冲区
+                if (node->pendingFreq.fetch_add(1, std::memory_order_relaxed) != 0)
+                    return true;
+                idx = stripe.writeIdx.fetch_add(1, std::memory_order_relaxed);
+                if (idx < kReadBufferSize)
+                    stripe.buffer[idx].store(node, std::memory_order_relaxed);
+                else
+                    pinned = it->second;
+            }
+            if (idx == kDrainThreshold)
+            {
+                scheduleDrain();
+            }
+            else if (pinned)
+            {
+                // 缓冲区已满，说明维护落后了，由当前线程同步完成
+                lockAll();
+                drainReadBuffers();
+                auto it = nodeMap_.find(pinned->key);
+                if (it != nodeMap_.end() && it->second == pinned)
+                    applyPending(pinned.get());
+                unlockAll();
+            }
+            return found;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        // 设置后台维护线程池(需在并发访问前调用)，读缓冲区的迁移交给后台执行
+        void setMaintenanceExecutor(std::shared_ptr<MaintenanceExecutor> executor)
+        {
+            maintenance_.setExecutor(std::move(executor));
+        }
+
+        // 立即执行一次批量维护：迁移所有读缓冲区中登记的节点
+        void maintenance()
+        {
+            lockAll();
+            drainReadBuffers();
+            unlockAll();
+        }
+
+        void purge()
+        {
+            lockAll();
+            drainReadBuffers();
+            nodeMap_.clear();
+            freqMap_.clear();
+            curTotalNum_ = 0;
+            curAverageNum_ = 0;
+            unlockAll();
+        }
+
+    private:
+        int currentStripe() const
+        {
+            static std::atomic<int> nextThreadId{0};
+            thread_local int threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+            return threadId % stripeNum_;
+        }
+
+        void lockAll()
+        {
+            for (int i = 0; i < stripeNum_; i++)
+                stripes_[i].mutex.lock();
+        }
+
+        void unlockAll()
+        {
+            for (int i = stripeNum_ - 1; i >= 0; i--)
+                stripes_[i].mutex.unlock();
+        }
+
+        void tryMaintenance()
+        {
+            for (int i = 0; i < stripeNum_; i++)
+            {
+                if (!stripes_[i].mutex.try_lock())
+                {
+                    // 有其他线程持有锁，放弃本次维护，交给后续的写操作或维护线程
+                    while (--i >= 0)
+                        stripes_[i].mutex.unlock();
+                    return;
+                }
+            }
+            drainReadBuffers();
+            unlockAll();
+        }
+
+        void scheduleDrain()
+        {
+            if (drainScheduled_.exchange(true))
+                return; // 已有维护任务在排队
+            bool scheduled = maintenance_.trySchedule([this]()
+                                                      {
+                drainScheduled_.store(false);
+                maintenance(); });
+            if (!scheduled)
+            {
+                drainScheduled_.store(false);
+                tryMaintenance();
+            }
+        }
+
+        // 调用前必须持有全部条带的写锁，此时没有读线程在写缓冲区
+        void drainReadBuffers()
+        {
+            for (int i = 0; i < stripeNum_; i++)
+            {
+                Stripe &stripe = stripes_[i];
+                size_t count = std::min(stripe.writeIdx.load(std::memory_order_relaxed), kReadBufferSize);
+                for (size_t j = 0; j < count; j++)
+                    applyPending(stripe.buffer[j].load(std::memory_order_relaxed));
+                stripe.writeIdx.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // 把节点累积的命中次数迁移到对应的频次链表
+        void applyPending(Node *node)
+        {
+            int hits = node->pendingFreq.exchange(0, std::memory_order_relaxed);
+            if (hits == 0)
+                return;
+            removeFromFreqList(node);
+            node->freq += hits;
+            addToFreqList(node);
+            addFreqNum(hits);
+        }
+
+        void putInternal(const Key &key, const Value &value)
+        {
+            if (nodeMap_.size() >= static_cast<size_t>(capacity_))
+                kickOut();
+            NodePtr node = makeCacheLineShared<Node>(key, value);
+            nodeMap_[key] = node;
+            addToFreqList(node.get());
+            addFreqNum(1);
+        }
+
+        void kickOut()
+        {
+            if (freqMap_.empty())
+                return;
+            Node *node = freqMap_.begin()->second.front();
+            removeFromFreqList(node);
+            curTotalNum_ -= node->freq;
+            nodeMap_.erase(nodeMap_.find(node->key)); // 释放节点，之后不能再访问node
+        }
+
+        void removeFromFreqList(Node *node)
+        {
+            auto it = freqMap_.find(node->freq);
+            it->second.erase(node->pos);
+            if (it->second.empty())
+                freqMap_.erase(it);
+        }
+
+        void addToFreqList(Node *node)
+        {
+            FreqList &list = freqMap_[node->freq];
+            list.push_back(node);
+            node->pos = std::prev(list.end());
+        }
+
+        void addFreqNum(int num)
+        {
+            curTotalNum_ += num;
+            if (nodeMap_.empty())
+                curAverageNum_ = 0;
+            else
+                curAverageNum_ = curTotalNum_ / nodeMap_.size();
+            if (curAverageNum_ > maxAverageNum_)
+                handleOverMaxAverageNum();
+        }
+
+        // 平均频次过高时整体衰减，调用前已持有全部写锁
+        void handleOverMaxAverageNum()
+        {
+            FreqMap aged;
+            curTotalNum_ = 0;
+            for (auto &pair : freqMap_)
+            {
+                for (Node *node : pair.second)
+                {
+                    node->freq -= maxAverageNum_ / 2;
+                    if (node->freq < 1)
+                        node->freq = 1;
+                    FreqList &list = aged[node->freq];
+                    list.push_back(node);
+                    node->pos = std::prev(list.end());
+                    curTotalNum_ += node->freq;
+                }
+            }
+            freqMap_.swap(aged);
+            curAverageNum_ = nodeMap_.empty() ? 0 : curTotalNum_ / nodeMap_.size();
+        }
+
+        int capacity_;       // 容量
+        int stripeNum_;      // 条带数量
+        int maxAverageNum_;  // 最大平均访问频次
+        int curAverageNum_;  // 当前平均访问频次
+        long long curTotalNum_; // 当前总访问频次
+
+        std::vector<Stripe, CacheLineAllocator<Stripe>> stripes_;
+        NodeMap nodeMap_;
+        FreqMap freqMap_; // 频次 -> 节点链表，begin()即最小频次
+        std::atomic<bool> drainScheduled_; // 是否已提交后台迁移任务
+        MaintenanceHandle maintenance_;     // 最后析构，先等待后台任务结束
+    };
+}
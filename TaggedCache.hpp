@@ -0,0 +1,181 @@
+#pragma once
+
+#include "CachePolicy.h"
+#include "LruCache.hpp"
+#include "NodeLayout.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MyCache
+{
+    // 底层缓存存放的条目：value和写入时各标签的代数
+    template <typename Value>
+    struct TaggedEntry
+    {
+        struct TagState
+        {
+            std::atomic<uint64_t> generation{0};
+        };
+
+        Value value;
+        std::vector<std::pair<std::shared_ptr<TagState>, uint64_t>> stamps;
+
+        bool valid() const
+        {
+            for (const auto &stamp : stamps)
+            {
+                if (stamp.first->generation.load(std::memory_order_acquire) != stamp.second)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    /* 按标签批量失效：put时给条目打上一个或多个标签，invalidateTag(tag)让带该标签的所有条目一次失效。
+       失效是惰性的：每个标签有一个代数，条目记下写入前各标签的代数，invalidateTag只把代数加一，
+       耗时与标签下的条目数无关，也不锁任何分片；get发现某个标签的代数变了就当作未命中。
+       失效的条目不在get里删除(检查和删除之间可能有新值写入，会被误删)，随淘汰退出或被下一次put覆盖。
+       条目直接持有标签状态的指针，get检查代数只是几次原子读，不查标签表。
+       标签表按标签哈希分条带加锁，只在put打标签和invalidateTag时访问；
+       标签表只持有弱引用，标签下的条目全部被淘汰后状态随之释放，表中过期的项在条带增长时清理。
+       写入与invalidateTag并发时偏向失效：先读代数再写入，期间被失效的条目按未命中处理，不会在失效之后还读到旧值。
+       所有写入都必须经过TaggedCache；Cache需要提供get(Key, Value&)、put(Key, Value)，用到remove时还需要remove(Key)，且自身线程安全。 */
+    template <typename Key, typename Value, typename Cache = HashLruCache<Key, std::shared_ptr<const TaggedEntry<Value>>>>
+    class TaggedCache : public CachePolicy<Key, Value>
+    {
+    public:
+        using Entry = TaggedEntry<Value>;
+        using EntryPtr = std::shared_ptr<const Entry>;
+
+        // tagStripes为标签表的条带数，向上取为2的幂
+        explicit TaggedCache(std::shared_ptr<Cache> cache, size_t tagStripes = 64)
+            : cache_(std::move(cache)), stripes_(roundUpPowerOfTwo(tagStripes))
+        {
+        }
+
+        // 不带标签的写入，只能按key删除
+        void put(Key key, Value value) override
+        {
+            put(std::move(key), std::move(value), {});
+        }
+
+        void put(Key key, Value value, const std::vector<std::string> &tags)
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->value = std::move(value);
+            entry->stamps.reserve(tags.size());
+            for (const std::string &tag : tags)
+            {
+                std::shared_ptr<TagState> state = stateOf(tag);
+                uint64_t generation = state->generation.load(std::memory_order_acquire);
+                entry->stamps.emplace_back(std::move(state), generation);
+            }
+            cache_->put(key, EntryPtr(std::move(entry)));
+        }
+
+        bool get(Key key, Value &value) override
+        {
+            EntryPtr entry;
+            if (!cache_->get(key, entry))
+                return false;
+            if (!entry->valid())
+                return false;
+            value = entry->value;
+            return true;
+        }
+
+        Value get(Key key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        void remove(Key key) { cache_->remove(key); }
+
+        // 让带tag的所有条目失效，之后的get都不会再返回它们
+        void invalidateTag(const std::string &tag)
+        {
+            TagStripe &stripe = stripeOf(tag);
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            auto it = stripe.tags.find(tag);
+            if (it == stripe.tags.end())
+                return;
+            std::shared_ptr<TagState> state = it->second.lock();
+            if (state)
+                state->generation.fetch_add(1, std::memory_order_release);
+            else
+                stripe.tags.erase(it); // 标签下已经没有条目
+        }
+
+        // 标签表中仍有条目引用的标签数
+        size_t tagCount()
+        {
+            size_t count = 0;
+            for (TagStripe &stripe : stripes_)
+            {
+                std::lock_guard<std::mutex> lock(stripe.mutex);
+                for (const auto &tag : stripe.tags)
+                    count += tag.second.expired() ? 0 : 1;
+            }
+            return count;
+        }
+
+        Cache &cache() { return *cache_; }
+
+    private:
+        using TagState = typename Entry::TagState;
+
+        // 每个条带独占缓存行，不同标签的put/invalidateTag互不干扰
+        struct alignas(kCacheLineSize) TagStripe
+        {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::weak_ptr<TagState>> tags;
+            size_t sweepAt = 64; // 表增长到这个大小时清理过期的项
+        };
+
+        static size_t roundUpPowerOfTwo(size_t n)
+        {
+            size_t size = 1;
+            while (size < n)
+                size <<= 1;
+            return size;
+        }
+
+        TagStripe &stripeOf(const std::string &tag)
+        {
+            return stripes_[std::hash<std::string>()(tag) & (stripes_.size() - 1)];
+        }
+
+        // 取tag的状态，不存在或已释放时新建
+        std::shared_ptr<TagState> stateOf(const std::string &tag)
+        {
+            TagStripe &stripe = stripeOf(tag);
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            std::weak_ptr<TagState> &slot = stripe.tags[tag];
+            std::shared_ptr<TagState> state = slot.lock();
+            if (state)
+                return state;
+            state = std::make_shared<TagState>();
+            slot = state;
+            if (stripe.tags.size() >= stripe.sweepAt)
+            {
+                for (auto it = stripe.tags.begin(); it != stripe.tags.end();)
+                    it = it->second.expired() ? stripe.tags.erase(it) : std::next(it);
+                stripe.sweepAt = std::max<size_t>(64, stripe.tags.size() * 2);
+            }
+            return state;
+        }
+
+        std::shared_ptr<Cache> cache_;
+        std::vector<TagStripe, CacheLineAllocator<TagStripe>> stripes_;
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef MYCACHE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace MyCache
+{
+    /* value压缩编解码。构建时找到zlib就用zlib(最快档)，否则退回内置的简单LZ77：
+       4字节哈希找最近一次出现的位置，输出(字面量长度, 字面量, 匹配长度, 偏移)序列，长度和偏移用变长整数。
+       内置编码压缩率不如zlib，但对JSON这类重复字段名多的数据通常也有2~3倍。
+       decompress需要调用方提供原始长度。 */
+    class ValueCodec
+    {
+    public:
+        enum class Kind
+        {
+            Builtin,
+            Zlib
+        };
+
+        // 不指定时取可用的最好实现
+        static Kind defaultKind()
+        {
+#ifdef MYCACHE_HAVE_ZLIB
+            return Kind::Zlib;
+#else
+            return Kind::Builtin;
+#endif
+        }
+
+        static bool available(Kind kind)
+        {
+            return kind == Kind::Builtin || defaultKind() == Kind::Zlib;
+        }
+
+        static const char *name(Kind kind) { return kind == Kind::Zlib ? "zlib" : "builtin"; }
+
+        static std::string compress(Kind kind, const std::string &input)
+        {
+#ifdef MYCACHE_HAVE_ZLIB
+            if (kind == Kind::Zlib)
+            {
+                uLongf size = compressBound(input.size());
+                std::string output(size, '\0');
+                if (compress2(reinterpret_cast<Bytef *>(&output[0]), &size,
+                              reinterpret_cast<const Bytef *>(input.data()), input.size(), Z_BEST_SPEED) != Z_OK)
+                    return std::string();
+                output.resize(size);
+                return output;
+            }
+#endif
+            (void)kind;
+            return builtinCompress(input);
+        }
+
+        // 数据损坏时返回false
+        static bool decompress(Kind kind, const std::string &input, size_t rawSize, std::string &output)
+        {
+#ifdef MYCACHE_HAVE_ZLIB
+            if (kind == Kind::Zlib)
+            {
+                output.resize(rawSize);
+                uLongf size = rawSize;
+                return uncompress(reinterpret_cast<Bytef *>(&output[0]), &size,
+                                  reinterpret_cast<const Bytef *>(input.data()), input.size()) == Z_OK &&
+                       size == rawSize;
+            }
+#endif
+            (void)kind;
+            return builtinDecompress(input, rawSize, output);
+        }
+
+    private:
+        static const size_t kMinMatch = 4;
+        static const int kHashBits = 12;
+
+        static void putVarint(std::string &output, size_t value)
+        {
+            while (value >= 0x80)
+            {
+                output += static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+            output += static_cast<char>(value);
+        }
+
+        static bool getVarint(const std::string &input, size_t &pos, size_t &value)
+        {
+            value = 0;
+            for (int shift = 0; pos < input.size() && shift < 64; shift += 7)
+            {
+                uint8_t byte = static_cast<uint8_t>(input[pos++]);
+                value |= static_cast<size_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        static uint32_t hash4(const char *p)
+        {
+            uint32_t word;
+            std::memcpy(&word, p, 4);
+            return (word * 2654435761u) >> (32 - kHashBits);
+        }
+
+        static std::string builtinCompress(const std::string &input)
+        {
+            std::string output;
+            output.reserve(input.size() / 2 + 16);
+            std::vector<int64_t> table(size_t(1) << kHashBits, -1); // 哈希值 -> 最近出现的位置
+            const char *data = input.data();
+            size_t n = input.size(), literalStart = 0, pos = 0;
+            while (pos + kMinMatch <= n)
+            {
+                uint32_t h = hash4(data + pos);
+                int64_t candidate = table[h];
+                table[h] = static_cast<int64_t>(pos);
+                if (candidate < 0 || std::memcmp(data + candidate, data + pos, kMinMatch) != 0)
+                {
+                    pos++;
+                    continue;
+                }
+                size_t length = kMinMatch;
+                while (pos + length < n && data[candidate + length] == data[pos + length])
+                    length++;
+                putVarint(output, pos - literalStart);
+                output.append(data + literalStart, pos - literalStart);
+                putVarint(output, length);
+                putVarint(output, pos - static_cast<size_t>(candidate));
+                pos += length;
+                literalStart = pos;
+            }
+            // 结尾的字面量，匹配长度为0表示结束
+            putVarint(output, n - literalStart);
+            output.append(data + literalStart, n - literalStart);
+            putVarint(output, 0);
+            return output;
+        }
+
+        static bool builtinDecompress(const std::string &input, size_t rawSize, std::string &output)
+        {
+            output.clear();
+            output.reserve(rawSize);
+            size_t pos = 0;
+            while (true)
+            {
+                size_t literals, length, offset;
+                if (!getVarint(input, pos, literals) || literals > input.size() - pos || output.size() + literals > rawSize)
+                    return false;
+                output.append(input, pos, literals);
+                pos += literals;
+                if (!getVarint(input, pos, length))
+                    return false;
+                if (length == 0)
+                    return output.size() == rawSize;
+                if (!getVarint(input, pos, offset) || offset == 0 || offset > output.size() || output.size() + length > rawSize)
+                    return false;
+                // 匹配可能与输出重叠，逐字节复制
+                size_t from = output.size() - offset;
+                for (size_t i = 0; i < length; ++i)
+                    output += output[from + i];
+            }
+        }
+    };
+}
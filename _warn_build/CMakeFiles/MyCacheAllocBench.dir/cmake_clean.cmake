@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheAllocBench.dir/bench_alloc.cpp.o"
+  "CMakeFiles/MyCacheAllocBench.dir/bench_alloc.cpp.o.d"
+  "MyCacheAllocBench"
+  "MyCacheAllocBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheAllocBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheAsyncTest.dir/test_async.cpp.o"
+  "CMakeFiles/MyCacheAsyncTest.dir/test_async.cpp.o.d"
+  "MyCacheAsyncTest"
+  "MyCacheAsyncTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheAsyncTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
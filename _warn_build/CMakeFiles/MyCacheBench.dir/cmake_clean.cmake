@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheBench.dir/bench.cpp.o"
+  "CMakeFiles/MyCacheBench.dir/bench.cpp.o.d"
+  "MyCacheBench"
+  "MyCacheBench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheBench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheLoadGen.dir/loadgen.cpp.o"
+  "CMakeFiles/MyCacheLoadGen.dir/loadgen.cpp.o.d"
+  "MyCacheLoadGen"
+  "MyCacheLoadGen.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheLoadGen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
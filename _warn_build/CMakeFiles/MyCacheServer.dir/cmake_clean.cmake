@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheServer.dir/server.cpp.o"
+  "CMakeFiles/MyCacheServer.dir/server.cpp.o.d"
+  "MyCacheServer"
+  "MyCacheServer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheServer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
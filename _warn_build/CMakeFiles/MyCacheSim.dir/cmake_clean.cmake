@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheSim.dir/simulator.cpp.o"
+  "CMakeFiles/MyCacheSim.dir/simulator.cpp.o.d"
+  "MyCacheSim"
+  "MyCacheSim.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheSim.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
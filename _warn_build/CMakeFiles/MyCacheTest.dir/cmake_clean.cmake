@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MyCacheTest.dir/test.cpp.o"
+  "CMakeFiles/MyCacheTest.dir/test.cpp.o.d"
+  "MyCacheTest"
+  "MyCacheTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MyCacheTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
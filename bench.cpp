@@ -0,0 +1,1163 @@
+#include "LruCache.hpp"
+#include "LfuCache.hpp"
+#include "StripedLfuCache.hpp"
+#include "ArcCache/ArcCache.hpp"
+#include "PerThreadCache.hpp"
+#include "ConcurrentLruCache.hpp"
+#include "NearCache.hpp"
+#include "Simulator/Workloads.hpp"
+#include "CompressedCache.hpp"
+#include "TaggedCache.hpp"
+#include "SlruCache.hpp"
+#include "MaintenanceExecutor.hpp"
+#include "ShardsTracker.hpp"
+#include "Engine/CacheEngine.hpp"
+#include "NumaTopology.hpp"
+#include "Distributed/DistributedCache.hpp"
+#include "CachePolicy.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 辅助函数：打印吞吐量
+void printThroughput(const std::string &name, int threads, long long ops, double seconds)
+{
+    std::cout << std::left << std::setw(16) << name
+              << " 线程数: " << std::setw(3) << threads
+              << " 吞吐量: " << std::fixed << std::setprecision(2)
+              << ops / seconds / 1e6 << " Mops/s" << std::endl;
+}
+
+// 辅助函数：打印延迟分位数（纳秒）
+void printLatency(const std::string &name, std::vector<long long> &latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p)
+    {
+        return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    std::cout << std::left << std::setw(24) << name
+              << " p50: " << std::setw(6) << percentile(0.50)
+              << " p99: " << std::setw(6) << percentile(0.99)
+              << " p99.9: " << std::setw(8) << percentile(0.999)
+              << " max: " << latencies.back() << " ns" << std::endl;
+}
+
+// 多线程执行同一个负载，返回耗时（秒）
+template <typename Func>
+double runThreads(int threads, Func func)
+{
+    std::vector<std::thread> workers;
+    std::atomic<bool> start(false);
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            while (!start.load())
+                std::this_thread::yield();
+            func(t); });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true);
+    for (auto &worker : workers)
+        worker.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+void benchReadHeavyLfu()
+{
+    std::cout << "\n=== 性能测试1：读多写少LFU (95%读) ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int KEYS = 20000;
+    const int OPS_PER_THREAD = 100000;
+    const int MAX_AVERAGE_NUM = 1000000; // 两者使用相同的老化阈值
+    const int threadCounts[] = {1, 8, 32};
+
+    for (int threads : threadCounts)
+    {
+        MyCache::HashLfuCache<int, int> hashLfu(CAPACITY, threads, MAX_AVERAGE_NUM);
+        MyCache::StripedLfuCache<int, int> stripedLfu(CAPACITY, threads, MAX_AVERAGE_NUM);
+        for (int key = 0; key < CAPACITY; ++key)
+        {
+            hashLfu.put(key, key);
+            stripedLfu.put(key, key);
+        }
+
+        auto workload = [&](auto &cache)
+        {
+            return runThreads(threads, [&](int t)
+                              {
+                std::mt19937 gen(t);
+                // 80%的访问集中在20%的键上
+                for (int op = 0; op < OPS_PER_THREAD; ++op)
+                {
+                    int key = (gen() % 100 < 80) ? gen() % (KEYS / 5) : gen() % KEYS;
+                    if (gen() % 100 < 5)
+                    {
+                        cache.put(key, op);
+                    }
+                    else
+                    {
+                        int value;
+                        cache.get(key, value);
+                    }
+                } });
+        };
+
+        long long totalOps = static_cast<long long>(threads) * OPS_PER_THREAD;
+        printThroughput("HashLfuCache", threads, totalOps, workload(hashLfu));
+        printThroughput("StripedLfuCache", threads, totalOps, workload(stripedLfu));
+    }
+}
+
+void benchMaintenanceLatency()
+{
+    std::cout << "\n=== 性能测试2：后台维护线程池对尾延迟的影响 ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const int SLICE_NUM = 4;
+    const int KEYS = 40000;
+    const int OPERATIONS = 400000;
+    const int MAX_AVERAGE_NUM = 10; // 较小的阈值使老化频繁发生
+
+    auto measure = [&](auto &cache)
+    {
+        std::vector<long long> latencies;
+        latencies.reserve(OPERATIONS);
+        std::mt19937 gen(42);
+        for (int op = 0; op < OPERATIONS; ++op)
+        {
+            int key = (gen() % 100 < 80) ? gen() % (KEYS / 10) : gen() % KEYS;
+            bool isPut = gen() % 100 < 30;
+            int value = 0;
+            auto begin = std::chrono::steady_clock::now();
+            if (isPut)
+                cache.put(key, op);
+            else
+                cache.get(key, value);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        }
+        return latencies;
+    };
+
+    auto executor = std::make_shared<MyCache::MaintenanceExecutor>(2);
+    {
+        MyCache::HashLfuCache<int, int> inlineLfu(CAPACITY, SLICE_NUM, MAX_AVERAGE_NUM);
+        MyCache::HashLfuCache<int, int> backgroundLfu(CAPACITY, SLICE_NUM, MAX_AVERAGE_NUM, executor);
+        auto inlineLatencies = measure(inlineLfu);
+        auto backgroundLatencies = measure(backgroundLfu);
+        printLatency("HashLfuCache 同步维护", inlineLatencies);
+        printLatency("HashLfuCache 后台维护", backgroundLatencies);
+    }
+    {
+        MyCache::HashLruCache<int, int> inlineLru(CAPACITY, SLICE_NUM);
+        MyCache::HashLruCache<int, int> backgroundLru(CAPACITY, SLICE_NUM, executor);
+        auto inlineLatencies = measure(inlineLru);
+        auto backgroundLatencies = measure(backgroundLru);
+        printLatency("HashLruCache 同步维护", inlineLatencies);
+        printLatency("HashLruCache 后台维护", backgroundLatencies);
+    }
+}
+
+void benchTrackerOverhead()
+{
+    std::cout << "\n=== 性能测试3：SHARDS估计器对命中路径的开销 ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int OPERATIONS = 2000000;
+    const int ROUNDS = 3;
+
+    std::vector<int> keys(OPERATIONS);
+    std::mt19937 gen(42);
+    for (auto &key : keys)
+        key = gen() % CAPACITY; // 全部命中
+
+    auto measure = [&](std::shared_ptr<MyCache::ShardsTracker<int>> tracker)
+    {
+        MyCache::LruCache<int, int> cache(CAPACITY);
+        for (int key = 0; key < CAPACITY; ++key)
+            cache.put(key, key);
+        cache.setMissRatioTracker(tracker);
+        double best = 1e9;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            int value = 0;
+            auto begin = std::chrono::steady_clock::now();
+            for (int key : keys)
+                cache.get(key, value);
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - begin).count());
+        }
+        return best;
+    };
+
+    double baseline = measure(nullptr);
+    printThroughput("LruCache", 1, OPERATIONS, baseline);
+    const double rates[] = {0.001, 0.01, 0.1};
+    for (double rate : rates)
+    {
+        double seconds = measure(std::make_shared<MyCache::ShardsTracker<int>>(rate));
+        std::cout << "采样率 " << std::setprecision(3) << std::setw(6) << rate << " 开销: "
+                  << std::setprecision(1) << (seconds / baseline - 1.0) * 100 << "%  ";
+        printThroughput("LruCache+SHARDS", 1, OPERATIONS, seconds);
+    }
+}
+
+void benchCacheEngine()
+{
+    std::cout << "\n=== 性能测试4：策略组合引擎与原有实现(单线程) ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int KEYS = 20000;
+    const int OPERATIONS = 2000000;
+    const int MAX_AVERAGE_NUM = 1000000;
+
+    std::vector<int> keys(OPERATIONS);
+    std::mt19937 gen(42);
+    for (auto &key : keys)
+        key = (gen() % 100 < 80) ? gen() % (KEYS / 10) : gen() % KEYS;
+
+    auto measure = [&](const std::string &name, auto &cache)
+    {
+        int value = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int key : keys)
+        {
+            if (!cache.get(key, value))
+                cache.put(key, key);
+        }
+        auto end = std::chrono::steady_clock::now();
+        printThroughput(name, 1, OPERATIONS, std::chrono::duration<double>(end - begin).count());
+    };
+
+    {
+        MyCache::LruCache<int, int> lru(CAPACITY);
+        MyCache::EngineLruCache<int, int> lockedLru(CAPACITY);
+        MyCache::EngineLruCache<int, int, MyCache::NullLock> bareLru(CAPACITY);
+        measure("LruCache", lru);
+        measure("Engine<LRU,mutex>", lockedLru);
+        measure("Engine<LRU,null>", bareLru);
+    }
+    {
+        MyCache::LfuCache<int, int> lfu(CAPACITY, MAX_AVERAGE_NUM);
+        MyCache::EngineLfuCache<int, int> lockedLfu(CAPACITY);
+        MyCache::EngineLfuCache<int, int, MyCache::NullLock> bareLfu(CAPACITY);
+        measure("LfuCache", lfu);
+        measure("Engine<LFU,mutex>", lockedLfu);
+        measure("Engine<LFU,null>", bareLfu);
+    }
+}
+
+// 通过虚接口调用
+long long virtualGetLoop(MyCache::CachePolicy<int, int> *cache, const std::vector<int> &keys)
+{
+    long long sum = 0;
+    int value = 0;
+    for (int key : keys)
+    {
+        if (cache->get(key, value))
+            sum += value;
+    }
+    return sum;
+}
+
+// 通过静态接口调用，get可以完全内联
+template <typename Derived>
+long long staticGetLoop(MyCache::StaticCachePolicy<Derived, int, int> &cache, const std::vector<int> &keys)
+{
+    long long sum = 0;
+    int value = 0;
+    for (int key : keys)
+    {
+        if (cache.get(key, value))
+            sum += value;
+    }
+    return sum;
+}
+
+void benchStaticDispatch()
+{
+    std::cout << "\n=== 性能测试5：虚函数分派与静态分派(int key, get循环) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int OPERATIONS = 5000000;
+    const int ROUNDS = 3;
+
+    std::vector<int> keys(OPERATIONS);
+    std::mt19937 gen(42);
+    for (auto &key : keys)
+        key = gen() % (CAPACITY * 2); // 一半命中
+
+    using Engine = MyCache::EngineLruCache<int, int, MyCache::NullLock>;
+    MyCache::VirtualCacheAdapter<Engine, int, int> adapter(CAPACITY);
+    std::vector<MyCache::CachePolicy<int, int> *> policies = {&adapter};
+    Engine engine(CAPACITY);
+    for (int key = 0; key < CAPACITY; ++key)
+    {
+        adapter.put(key, key);
+        engine.put(key, key);
+    }
+
+    auto measure = [&](const std::string &name, auto loop)
+    {
+        double best = 1e9;
+        long long checksum = 0;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            checksum += loop();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - begin).count());
+        }
+        printThroughput(name, 1, OPERATIONS, best);
+        return checksum;
+    };
+
+    long long virtualSum = measure("虚接口", [&]()
+                                   { return virtualGetLoop(policies[0], keys); });
+    long long staticSum = measure("静态接口", [&]()
+                                  { return staticGetLoop(engine, keys); });
+    if (virtualSum != staticSum)
+        std::cout << "结果不一致: " << virtualSum << " vs " << staticSum << std::endl;
+}
+
+void benchThreadPerCore()
+{
+    std::cout << "\n=== 性能测试6：不加锁的单线程版本与每线程独占缓存 ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int KEYS = 20000;
+    const int OPS_PER_THREAD = 1000000;
+    const int MAX_AVERAGE_NUM = 1000000;
+
+    std::vector<int> keys(OPS_PER_THREAD);
+    std::mt19937 gen(42);
+    for (auto &key : keys)
+        key = (gen() % 100 < 80) ? gen() % (KEYS / 10) : gen() % KEYS;
+
+    auto access = [&](auto &cache)
+    {
+        int value = 0;
+        for (int key : keys)
+        {
+            if (!cache.get(key, value))
+                cache.put(key, key);
+        }
+    };
+    auto measure = [&](const std::string &name, auto &cache)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        access(cache);
+        auto end = std::chrono::steady_clock::now();
+        printThroughput(name, 1, OPS_PER_THREAD, std::chrono::duration<double>(end - begin).count());
+    };
+
+    {
+        MyCache::LruCache<int, int> locked(CAPACITY);
+        MyCache::LruCache<int, int, MyCache::NullLock> bare(CAPACITY);
+        measure("LRU std::mutex", locked);
+        measure("LRU NullLock", bare);
+    }
+    {
+        MyCache::LfuCache<int, int> locked(CAPACITY, MAX_AVERAGE_NUM);
+        MyCache::LfuCache<int, int, MyCache::NullLock> bare(CAPACITY, MAX_AVERAGE_NUM);
+        measure("LFU std::mutex", locked);
+        measure("LFU NullLock", bare);
+    }
+    {
+        MyCache::ArcCache<int, int> locked(CAPACITY);
+        MyCache::ArcCache<int, int, MyCache::NullLock> bare(CAPACITY);
+        measure("ARC std::mutex", locked);
+        measure("ARC NullLock", bare);
+    }
+
+    // 多线程：共享的分片缓存 vs 每线程独占一份(总容量相同)
+    const int threadCounts[] = {1, 4, 8};
+    for (int threads : threadCounts)
+    {
+        MyCache::HashLruCache<int, int> shared(CAPACITY * threads, threads);
+        MyCache::PerThreadCache<MyCache::LruCache<int, int, MyCache::NullLock>> perThread(CAPACITY);
+        long long totalOps = 1LL * threads * OPS_PER_THREAD;
+        printThroughput("HashLruCache", threads, totalOps, runThreads(threads, [&](int)
+                                                                      { access(shared); }));
+        printThroughput("PerThreadCache", threads, totalOps, runThreads(threads, [&](int)
+                                                                        { access(perThread.local()); }));
+    }
+}
+
+void benchConcurrentLru()
+{
+    std::cout << "\n=== 性能测试7：读无锁LRU与分片LRU (95%读) ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int KEYS = 20000;
+    const int OPS_PER_THREAD = 200000;
+    const int threadCounts[] = {1, 8, 32};
+
+    for (int threads : threadCounts)
+    {
+        MyCache::HashLruCache<int, int> hashLru(CAPACITY, threads);
+        MyCache::ConcurrentLruCache<int, int> concurrentLru(CAPACITY);
+        for (int key = 0; key < CAPACITY; ++key)
+        {
+            hashLru.put(key, key);
+            concurrentLru.put(key, key);
+        }
+
+        auto workload = [&](auto &cache)
+        {
+            return runThreads(threads, [&](int t)
+                              {
+                std::mt19937 gen(t);
+                int value = 0;
+                for (int op = 0; op < OPS_PER_THREAD; ++op)
+                {
+                    int key = gen() % KEYS;
+                    if (gen() % 100 < 95)
+                        cache.get(key, value);
+                    else
+                        cache.put(key, op);
+                } });
+        };
+
+        long long totalOps = 1LL * threads * OPS_PER_THREAD;
+        printThroughput("HashLruCache", threads, totalOps, workload(hashLru));
+        printThroughput("ConcurrentLru", threads, totalOps, workload(concurrentLru));
+    }
+}
+
+void benchNumaSharding()
+{
+    std::cout << "\n=== 性能测试9：NUMA分片放置 ===" << std::endl;
+
+    // 单节点机器上模拟两个节点，只验证放置逻辑，不反映跨节点访问的真实开销
+    auto topology = std::make_shared<MyCache::NumaTopology>(MyCache::NumaTopology::detect());
+    if (topology->nodeCount() < 2)
+        topology = std::make_shared<MyCache::NumaTopology>(MyCache::NumaTopology::simulated(2));
+    std::cout << "节点数: " << topology->nodeCount() << (topology->isSimulated() ? " (模拟)" : "") << std::endl;
+
+    const int THREADS = 4;
+    const int OPERATIONS = 200000;
+    const int KEYS_PER_THREAD = 5000;
+    const int CAPACITY = THREADS * KEYS_PER_THREAD / 2;
+    const int SLICE_NUM = 8;
+
+    // 每个线程绑定到一个节点，90%的访问落在自己的key区间(会话亲和)，其余访问所有线程共享的区间
+    auto run = [&](const std::string &name, auto &cache)
+    {
+        std::atomic<long long> hits(0), local(0), placed(0);
+        double seconds = runThreads(THREADS, [&](int t)
+                                    {
+            int node = t % topology->nodeCount();
+            topology->bindCurrentThread(node);
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> dist(0, KEYS_PER_THREAD - 1);
+            std::uniform_int_distribution<> percent(0, 99);
+            auto nextKey = [&]()
+            {
+                int owner = percent(gen) < 90 ? t : THREADS;
+                return owner * KEYS_PER_THREAD + dist(gen);
+            };
+            long long localHits = 0;
+            int value = 0;
+            for (int i = 0; i < OPERATIONS; ++i)
+            {
+                int key = nextKey();
+                if (cache.get(key, value))
+                    localHits++;
+                else
+                    cache.put(key, key);
+            }
+            hits += localHits;
+            // 统计落在本节点分片上的访问比例(计时之后单独统计，不影响吞吐量)
+            long long localAccesses = 0, placedAccesses = 0;
+            for (int i = 0; i < OPERATIONS / 10; ++i)
+            {
+                int owner = cache.nodeOf(nextKey());
+                placedAccesses += owner >= 0;
+                localAccesses += owner == node;
+            }
+            local += localAccesses;
+            placed += placedAccesses; });
+        printThroughput(name, THREADS, static_cast<long long>(THREADS) * OPERATIONS, seconds);
+        std::cout << "  命中率: " << std::fixed << std::setprecision(2) << 100.0 * hits / (THREADS * OPERATIONS) << "%"
+                  << "  本节点访问: ";
+        if (placed > 0)
+            std::cout << 100.0 * local / placed << "%" << std::endl;
+        else
+            std::cout << "未知" << std::endl;
+    };
+
+    MyCache::HashLruCache<int, int> plain(CAPACITY, SLICE_NUM);
+    run("HashLru", plain);
+    // 分片按哈希轮流放到各节点，分片和节点内存绑定在所在节点
+    MyCache::HashLruCache<int, int> placedByHash(CAPACITY, SLICE_NUM);
+    placedByHash.setNumaTopology(topology);
+    run("NumaHashLru", placedByHash);
+    // 按节点分区，线程只访问本节点的分片
+    MyCache::HashLruCache<int, int> preferLocal(CAPACITY, SLICE_NUM);
+    preferLocal.setNumaTopology(topology, true);
+    run("NumaLocalLru", preferLocal);
+}
+
+// 硬件计数器：只统计本线程用户态的事件，perf_event不可用(容器、虚拟机)时available()为false
+class PerfCounter
+{
+public:
+    PerfCounter(uint32_t type, uint64_t config) : fd_(-1)
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)type;
+        (void)config;
+#endif
+    }
+
+    ~PerfCounter()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t stop()
+    {
+        uint64_t value = 0;
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &value, sizeof(value)) != sizeof(value))
+                value = 0;
+        }
+#endif
+        return value;
+    }
+
+private:
+    int fd_;
+};
+
+// 防止被测循环的结果被优化掉
+volatile long long benchSink = 0;
+
+// 调整之前的LruNode布局：未使用的条件变量在最前，访问次数排在key/value之后
+struct LegacyLayoutNode
+{
+    std::condition_variable cd;
+    std::weak_ptr<LegacyLayoutNode> prev;
+    std::shared_ptr<LegacyLayoutNode> next;
+    int key;
+    int value;
+    size_t accessCount = 1;
+};
+
+// 现在的布局：热字段在前，节点按缓存行对齐分配
+struct CompactLayoutNode
+{
+    std::weak_ptr<CompactLayoutNode> prev;
+    std::shared_ptr<CompactLayoutNode> next;
+    size_t accessCount = 1;
+    int key;
+    int value;
+};
+
+// 按LruCache命中路径的操作顺序访问节点：计数加一、摘下、挂到表尾、读出value
+template <typename Node>
+long long simulateLruHits(std::vector<std::shared_ptr<Node>> &nodes, const std::vector<int> &accesses,
+                          std::shared_ptr<Node> &tail)
+{
+    long long sum = 0;
+    for (int index : accesses)
+    {
+        std::shared_ptr<Node> node = nodes[index];
+        node->accessCount++;
+        if (node->next)
+        {
+            auto prev = node->prev.lock();
+            prev->next = node->next;
+            node->next->prev = prev;
+            node->next = tail;
+            node->prev = tail->prev;
+            tail->prev.lock()->next = node;
+            tail->prev = node;
+        }
+        sum += node->value;
+    }
+    return sum;
+}
+
+template <typename Node, typename Factory>
+void measureNodeLayout(const std::string &name, Factory makeNode, const std::vector<int> &accesses, int nodeCount)
+{
+    std::vector<std::shared_ptr<Node>> nodes;
+    nodes.reserve(nodeCount);
+    std::shared_ptr<Node> head = makeNode(), tail = makeNode();
+    head->next = tail;
+    tail->prev = head;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        nodes.push_back(makeNode());
+        nodes.back()->key = i;
+        nodes.back()->value = i;
+        nodes.back()->next = tail;
+        nodes.back()->prev = tail->prev;
+        tail->prev.lock()->next = nodes.back();
+        tail->prev = nodes.back();
+    }
+
+    PerfCounter l1Misses(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    PerfCounter llcMisses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    l1Misses.start();
+    llcMisses.start();
+    auto begin = std::chrono::steady_clock::now();
+    long long sum = simulateLruHits(nodes, accesses, tail);
+    auto end = std::chrono::steady_clock::now();
+    uint64_t l1 = l1Misses.stop();
+    uint64_t llc = llcMisses.stop();
+
+    double nsPerHit = std::chrono::duration<double, std::nano>(end - begin).count() / accesses.size();
+    std::cout << std::left << std::setw(16) << name << " 节点大小: " << std::setw(4) << sizeof(Node)
+              << " 每次命中: " << std::fixed << std::setprecision(1) << std::setw(6) << nsPerHit << " ns";
+    if (l1Misses.available() && llcMisses.available())
+        std::cout << "  L1D未命中/次: " << std::setprecision(2) << static_cast<double>(l1) / accesses.size()
+                  << "  LLC未命中/次: " << static_cast<double>(llc) / accesses.size();
+    else
+        std::cout << "  (perf_event不可用，只统计耗时)";
+    std::cout << std::endl;
+    benchSink = sum;
+
+    // 逐个断开，避免长链表递归析构
+    for (auto &node : nodes)
+        node->next.reset();
+    head->next.reset();
+}
+
+void benchNodeLayout()
+{
+    std::cout << "\n=== 性能测试10：节点内存布局 ===" << std::endl;
+
+    const int ACCESSES = 1000000;
+    // 新布局能放进L2而旧布局放不进，以及两者都远超末级缓存
+    for (int nodeCount : {1 << 14, 1 << 20})
+    {
+        std::cout << "节点数: " << nodeCount << std::endl;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> dist(0, nodeCount - 1);
+        std::vector<int> accesses(ACCESSES);
+        for (auto &index : accesses)
+            index = dist(gen);
+
+        measureNodeLayout<LegacyLayoutNode>("LegacyNode", []()
+                                            { return std::make_shared<LegacyLayoutNode>(); }, accesses, nodeCount);
+        measureNodeLayout<CompactLayoutNode>("HotFirstNode", []()
+                                             { return MyCache::makeCacheLineShared<CompactLayoutNode>(); }, accesses, nodeCount);
+    }
+}
+
+void benchScanResistantPolicies()
+{
+    std::cout << "\n=== 性能测试11：抗扫描LRU变体的单线程开销 ===" << std::endl;
+
+    const int CAPACITY = 10000;
+    const int OPERATIONS = 2000000;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> dist(0, CAPACITY * 2 - 1);
+    std::vector<int> keys(OPERATIONS);
+    for (auto &key : keys)
+        key = dist(gen);
+
+    // 读穿透：未命中时写入
+    auto run = [&](const std::string &name, MyCache::CachePolicy<int, int> &cache)
+    {
+        int value = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int key : keys)
+        {
+            if (!cache.get(key, value))
+                cache.put(key, key);
+        }
+        auto end = std::chrono::steady_clock::now();
+        printThroughput(name, 1, OPERATIONS, std::chrono::duration<double>(end - begin).count());
+    };
+
+    MyCache::LruCache<int, int> lru(CAPACITY);
+    MyCache::LruKCache<int, int> lruk(CAPACITY, CAPACITY * 4, 2);
+    MyCache::SlruCache<int, int> slru(CAPACITY);
+    MyCache::TwoQueueCache<int, int> twoQueue(CAPACITY);
+    run("LruCache", lru);
+    run("LruKCache", lruk);
+    run("SlruCache", slru);
+    run("TwoQueueCache", twoQueue);
+}
+
+void benchRebalancing()
+{
+    std::cout << "\n=== 性能测试12：节点增减时的命中率损失(一致性哈希 vs 取模) ===" << std::endl;
+
+    const int NODE_CAPACITY = 20000;
+    const uint64_t KEY_NUM = 500000;
+    const uint64_t WINDOW = 50000;    // 每个统计窗口的访问次数
+    const int WINDOWS_PER_PHASE = 4;
+
+    // 取模路由作为对照：节点数变化时几乎所有key都换节点
+    struct ModuloCache
+    {
+        std::vector<std::shared_ptr<MyCache::LocalCacheNode<uint64_t, uint64_t>>> nodes;
+        MyCache::LocalCacheNode<uint64_t, uint64_t> &nodeFor(uint64_t key)
+        {
+            return *nodes[MyCache::mixKey(key) % nodes.size()];
+        }
+    };
+
+    auto makeNode = [&]()
+    {
+        return std::make_shared<MyCache::LocalCacheNode<uint64_t, uint64_t>>(NODE_CAPACITY, 4);
+    };
+
+    MyCache::DistributedCache<uint64_t, uint64_t> ring;
+    ModuloCache modulo;
+    for (int i = 0; i < 4; ++i)
+    {
+        ring.addNode("node" + std::to_string(i), makeNode());
+        modulo.nodes.push_back(makeNode());
+    }
+
+    // 记录增加节点前后换了节点的key的比例
+    const uint64_t SAMPLE = 100000;
+    std::vector<std::string> ringBefore(SAMPLE);
+    for (uint64_t key = 0; key < SAMPLE; ++key)
+        ringBefore[key] = ring.nodeNameOf(key);
+
+    MyCache::ZipfGenerator ringZipf(KEY_NUM, 0.9, UINT64_MAX, 12);
+    MyCache::ZipfGenerator moduloZipf(KEY_NUM, 0.9, UINT64_MAX, 12);
+    auto runWindow = [&](std::vector<double> &ringRates, std::vector<double> &moduloRates)
+    {
+        uint64_t ringHits = 0, moduloHits = 0, key, value;
+        for (uint64_t i = 0; i < WINDOW; ++i)
+        {
+            ringZipf.next(key);
+            if (ring.get(key, value))
+                ringHits++;
+            else
+                ring.put(key, key);
+            moduloZipf.next(key);
+            if (modulo.nodeFor(key).get(key, value))
+                moduloHits++;
+            else
+                modulo.nodeFor(key).put(key, key);
+        }
+        ringRates.push_back(100.0 * ringHits / WINDOW);
+        moduloRates.push_back(100.0 * moduloHits / WINDOW);
+    };
+
+    std::vector<double> ringRates, moduloRates, warmup;
+    for (int i = 0; i < WINDOWS_PER_PHASE * 4; ++i)
+        runWindow(warmup, warmup); // 预热，不计入
+    for (int i = 0; i < WINDOWS_PER_PHASE; ++i)
+        runWindow(ringRates, moduloRates);
+
+    ring.addNode("node4", makeNode());
+    modulo.nodes.push_back(makeNode());
+    size_t moved = 0, moduloMoved = 0;
+    for (uint64_t key = 0; key < SAMPLE; ++key)
+    {
+        moved += ring.nodeNameOf(key) != ringBefore[key];
+        moduloMoved += MyCache::mixKey(key) % 4 != MyCache::mixKey(key) % 5;
+    }
+    for (int i = 0; i < WINDOWS_PER_PHASE; ++i)
+        runWindow(ringRates, moduloRates);
+
+    ring.removeNode("node1");
+    modulo.nodes.erase(modulo.nodes.begin() + 1);
+    for (int i = 0; i < WINDOWS_PER_PHASE; ++i)
+        runWindow(ringRates, moduloRates);
+
+    std::cout << "增加第5个节点后换节点的key: 一致性哈希 " << std::fixed << std::setprecision(1)
+              << 100.0 * moved / SAMPLE << "%，取模 " << 100.0 * moduloMoved / SAMPLE << "%" << std::endl;
+    std::cout << "每" << WINDOW << "次访问的命中率(4个窗口后加节点，再4个窗口后删节点):" << std::endl;
+    for (size_t i = 0; i < ringRates.size(); ++i)
+    {
+        const char *phase = i < WINDOWS_PER_PHASE ? "4节点" : (i < 2 * WINDOWS_PER_PHASE ? "加入node4" : "移除node1");
+        std::cout << std::left << std::setw(14) << phase << std::right << " 窗口" << std::setw(2) << i + 1
+                  << "  一致性哈希: " << std::setw(6) << ringRates[i] << "%  取模: " << std::setw(6) << moduloRates[i] << "%" << std::endl;
+    }
+}
+
+void benchNearCache()
+{
+    std::cout << "\n=== 性能测试13：线程局部L1近端缓存 (Zipf 1.2, 99%读) ===" << std::endl;
+
+    const int CAPACITY = 50000;
+    const uint64_t KEYS = 100000;
+    const int OPS_PER_THREAD = 500000;
+    const int threadCounts[] = {1, 8, 32};
+
+    for (int threads : threadCounts)
+    {
+        auto hashLru = std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 8);
+        MyCache::NearCache<uint64_t, uint64_t> near(std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 8));
+        for (uint64_t key = 0; key < CAPACITY; ++key)
+        {
+            hashLru->put(key, key);
+            near.put(key, key);
+        }
+
+        // 访问序列提前生成，不把Zipf采样的开销算进去
+        std::vector<std::vector<uint64_t>> streams(threads);
+        for (int t = 0; t < threads; ++t)
+        {
+            MyCache::ZipfGenerator zipf(KEYS, 1.2, OPS_PER_THREAD, t + 1);
+            uint64_t key;
+            while (zipf.next(key))
+                streams[t].push_back(key);
+        }
+
+        auto workload = [&](auto &cache)
+        {
+            return runThreads(threads, [&](int t)
+                              {
+                uint64_t value = 0;
+                long long sum = 0;
+                for (int op = 0; op < OPS_PER_THREAD; ++op)
+                {
+                    uint64_t key = streams[t][op];
+                    if (op % 100 == 0)
+                        cache.put(key, key);
+                    else if (cache.get(key, value))
+                        sum += value;
+                }
+                benchSink = sum; });
+        };
+
+        long long totalOps = 1LL * threads * OPS_PER_THREAD;
+        printThroughput("HashLruCache", threads, totalOps, workload(*hashLru));
+        printThroughput("NearCache", threads, totalOps, workload(near));
+
+        // 两个实例交替访问：每次切换实例都查线程局部的编号表，不走线程登记的互斥锁
+        MyCache::NearCache<uint64_t, uint64_t> other(std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 8));
+        for (uint64_t key = 0; key < CAPACITY; ++key)
+            other.put(key, key);
+        printThroughput("NearCache x2交替", threads, totalOps, runThreads(threads, [&](int t)
+                                                                        {
+            uint64_t value = 0;
+            long long sum = 0;
+            for (int op = 0; op < OPS_PER_THREAD; ++op)
+            {
+                uint64_t key = streams[t][op];
+                auto &cache = (op & 1) ? other : near;
+                if (op % 100 == 0)
+                    cache.put(key, key);
+                else if (cache.get(key, value))
+                    sum += value;
+            }
+            benchSink = sum; }));
+    }
+}
+
+// 与测试中的记录形状相同：字段名重复较多的约1KB JSON
+std::string makeJsonRecord(uint64_t id)
+{
+    uint64_t h = MyCache::mixKey(id);
+    std::string record = "{\"id\":" + std::to_string(id) + ",\"name\":\"user_" + std::to_string(id) +
+                         "\",\"score\":" + std::to_string(h % 10000) + ",\"history\":[";
+    for (int i = 0; i < 16; ++i)
+        record += std::string(i ? "," : "") + "{\"event\":\"" + (((h >> i) & 3) ? "login" : "logout") + "\",\"ts\":" +
+                  std::to_string(1700000000 + (h >> i) % 100000 + i * 60) + ",\"ok\":true}";
+    record += "]}";
+    return record;
+}
+
+void benchCompressedCache()
+{
+    std::cout << "\n=== 性能测试14：冷条目透明压缩 (Zipf 0.9, 95%读, 单线程) ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const size_t HOT = 2000;
+    const uint64_t KEYS = 40000;
+    const int OPERATIONS = 400000;
+
+    std::vector<uint64_t> stream;
+    MyCache::ZipfGenerator zipf(KEYS, 0.9, OPERATIONS, 7);
+    uint64_t key;
+    while (zipf.next(key))
+        stream.push_back(key);
+    std::vector<std::string> records(KEYS);
+    for (uint64_t k = 0; k < KEYS; ++k)
+        records[k] = makeJsonRecord(k);
+
+    auto workload = [&](MyCache::CachePolicy<uint64_t, std::string> &cache)
+    {
+        return runThreads(1, [&](int)
+                          {
+            std::string value;
+            long long sum = 0;
+            for (int op = 0; op < OPERATIONS; ++op)
+            {
+                uint64_t k = stream[op];
+                if (op % 20 == 0 || !cache.get(k, value))
+                    cache.put(k, records[k]);
+                else
+                    sum += value.size();
+            }
+            benchSink = sum; });
+    };
+
+    MyCache::LruCache<uint64_t, std::string> plain(CAPACITY);
+    printThroughput("LruCache", 1, OPERATIONS, workload(plain));
+
+    MyCache::ValueCodec::Kind kinds[] = {MyCache::ValueCodec::Kind::Builtin, MyCache::ValueCodec::Kind::Zlib};
+    for (MyCache::ValueCodec::Kind kind : kinds)
+    {
+        if (!MyCache::ValueCodec::available(kind))
+            continue;
+        MyCache::CompressedCache<uint64_t, MyCache::LruCache> compressed(HOT, kind, CAPACITY);
+        std::string name = std::string("Compressed(") + MyCache::ValueCodec::name(kind) + ")";
+        printThroughput(name, 1, OPERATIONS, workload(compressed));
+        std::cout << std::left << std::setw(16) << "" << " value占用 " << compressed.storedBytes() / 1024 << " KB / 原文 "
+                  << compressed.rawBytes() / 1024 << " KB, 压缩 " << compressed.compressions() << " 次, 解压 "
+                  << compressed.decompressions() << " 次" << std::endl;
+    }
+}
+
+void benchTagInvalidation()
+{
+    std::cout << "\n=== 性能测试15：按租户批量失效 (20万key, 20个租户) ===" << std::endl;
+
+    const int CAPACITY = 200000;
+    const uint64_t KEYS = 200000;
+    const uint64_t TENANTS = 20;
+
+    using Entry = std::shared_ptr<const MyCache::TaggedEntry<uint64_t>>;
+    MyCache::HashLruCache<uint64_t, uint64_t> plain(CAPACITY, 8);
+    MyCache::TaggedCache<uint64_t, uint64_t> tagged(std::make_shared<MyCache::HashLruCache<uint64_t, Entry>>(CAPACITY, 8));
+    std::vector<std::string> tenantTags;
+    for (uint64_t t = 0; t < TENANTS; ++t)
+        tenantTags.push_back("tenant:" + std::to_string(t));
+    for (uint64_t key = 0; key < KEYS; ++key)
+    {
+        plain.put(key, key);
+        tagged.put(key, key, {tenantTags[key % TENANTS]});
+    }
+
+    // 逐个删除需要调用方自己记住租户下的所有key
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t key = 3; key < KEYS; key += TENANTS)
+        plain.remove(key);
+    double removeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    tagged.invalidateTag(tenantTags[3]);
+    double invalidateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << std::left << std::setw(16) << "remove" << " 逐个失效 " << KEYS / TENANTS << " 个key: "
+              << std::fixed << std::setprecision(1) << removeSeconds * 1e6 << " us" << std::endl;
+    std::cout << std::left << std::setw(16) << "invalidateTag" << " 一次失效 " << KEYS / TENANTS << " 个key: "
+              << std::fixed << std::setprecision(1) << invalidateSeconds * 1e6 << " us" << std::endl;
+
+    // 读路径多了标签代数检查，比较全部命中时的读吞吐
+    const int OPS_PER_THREAD = 500000;
+    const int THREADS = 8;
+    auto workload = [&](auto &cache)
+    {
+        return runThreads(THREADS, [&](int t)
+                          {
+            uint64_t value = 0;
+            long long sum = 0;
+            std::mt19937_64 rng(t + 1);
+            for (int op = 0; op < OPS_PER_THREAD; ++op)
+            {
+                uint64_t key = rng() % KEYS;
+                if (key % TENANTS == 3)
+                    key++;
+                if (cache.get(key, value))
+                    sum += value;
+            }
+            benchSink = sum; });
+    };
+    long long totalOps = 1LL * THREADS * OPS_PER_THREAD;
+    printThroughput("HashLruCache", THREADS, totalOps, workload(plain));
+    printThroughput("TaggedCache", THREADS, totalOps, workload(tagged));
+}
+
+void benchScanLatency()
+{
+    std::cout << "\n=== 性能测试16：遍历对在线读延迟的影响 (200万条目, 8分片) ===" << std::endl;
+
+    const int CAPACITY = 2000000;
+    const uint64_t KEYS = 2000000;
+    const int OPERATIONS = 300000;
+
+    MyCache::HashLruCache<uint64_t, uint64_t> cache(CAPACITY, 8);
+    for (uint64_t key = 0; key < KEYS; ++key)
+        cache.put(key, key);
+
+    // chunkSize为0表示不遍历；chunkSize足够大时每个分片一次走完，相当于持锁遍历整个分片
+    auto measure = [&](size_t chunkSize)
+    {
+        std::atomic<bool> done(false);
+        std::atomic<long long> scanned(0);
+        std::thread scanner([&]()
+                            {
+            std::vector<std::pair<uint64_t, uint64_t>> chunk;
+            while (chunkSize && !done.load())
+            {
+                auto scan = cache.scan();
+                while (!done.load() && scan.next(chunk, chunkSize))
+                    scanned += chunk.size();
+            } });
+        std::vector<long long> latencies;
+        latencies.reserve(OPERATIONS);
+        std::mt19937_64 gen(42);
+        uint64_t value = 0;
+        for (int op = 0; op < OPERATIONS; ++op)
+        {
+            uint64_t key = gen() % KEYS;
+            auto begin = std::chrono::steady_clock::now();
+            cache.get(key, value);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        }
+        done = true;
+        scanner.join();
+        benchSink = scanned.load();
+        return latencies;
+    };
+
+    auto idle = measure(0);
+    auto chunked = measure(256);
+    auto whole = measure(CAPACITY);
+    printLatency("不遍历", idle);
+    printLatency("分块遍历(256)", chunked);
+    printLatency("整片持锁遍历", whole);
+}
+
+void benchOnlineResize()
+{
+    std::cout << "\n=== 性能测试17：在线调整容量的持锁时间 (LruCache) ===" << std::endl;
+
+    const int LARGE = 1000000;
+    const int SMALL = 100000;
+    auto elapsedUs = [](std::chrono::steady_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    };
+    auto fill = [](MyCache::LruCache<uint64_t, uint64_t> &cache, uint64_t from, uint64_t to)
+    {
+        double longest = 0;
+        for (uint64_t key = from; key < to; ++key)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            cache.put(key, key);
+            longest = std::max(longest, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+        }
+        return longest;
+    };
+
+    // 缩容：一次淘汰完(相当于原来持锁循环淘汰)与每批64个对比最长持锁时间
+    {
+        MyCache::LruCache<uint64_t, uint64_t> cache(LARGE);
+        fill(cache, 0, LARGE);
+        cache.setCapacity(SMALL);
+        auto begin = std::chrono::steady_clock::now();
+        cache.evictExcess(LARGE);
+        std::cout << std::left << std::setw(24) << "缩容 一次淘汰完" << " 最长持锁: " << std::fixed << std::setprecision(1)
+                  << elapsedUs(begin) << " us" << std::endl;
+    }
+    {
+        MyCache::LruCache<uint64_t, uint64_t> cache(LARGE);
+        fill(cache, 0, LARGE);
+        cache.setCapacity(SMALL);
+        double longest = 0;
+        int batches = 0;
+        for (bool remaining = true; remaining; batches++)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            remaining = cache.evictExcess(64);
+            longest = std::max(longest, elapsedUs(begin));
+        }
+        std::cout << std::left << std::setw(24) << "缩容 每批64个" << " 最长持锁: " << std::fixed << std::setprecision(1)
+                  << longest << " us (" << batches << " 批)" << std::endl;
+    }
+
+    // 扩容：setCapacity预留桶之后填满，对比不预留、填满过程中逐级rehash时最慢的一次put
+    {
+        MyCache::LruCache<uint64_t, uint64_t> cache(LARGE);
+        double longest = fill(cache, 0, LARGE);
+        std::cout << std::left << std::setw(24) << "扩容 不预留" << " 最慢put: " << std::fixed << std::setprecision(1)
+                  << longest << " us" << std::endl;
+    }
+    {
+        MyCache::LruCache<uint64_t, uint64_t> cache(SMALL);
+        fill(cache, 0, SMALL);
+        auto begin = std::chrono::steady_clock::now();
+        cache.setCapacity(LARGE);
+        double reserveUs = elapsedUs(begin);
+        double longest = fill(cache, SMALL, LARGE);
+        std::cout << std::left << std::setw(24) << "扩容 setCapacity预留" << " 最慢put: " << std::fixed << std::setprecision(1)
+                  << longest << " us (setCapacity " << reserveUs << " us)" << std::endl;
+    }
+}
+
+int main()
+{
+    benchReadHeavyLfu();
+    benchMaintenanceLatency();
+    benchTrackerOverhead();
+    benchCacheEngine();
+    benchStaticDispatch();
+    benchThreadPerCore();
+    benchConcurrentLru();
+    benchNumaSharding();
+    benchNodeLayout();
+    benchScanResistantPolicies();
+    benchRebalancing();
+    benchNearCache();
+    benchCompressedCache();
+    benchTagInvalidation();
+    benchScanLatency();
+    benchOnlineResize();
+
+    return 0;
+}
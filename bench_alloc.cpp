@@ -0,0 +1,92 @@
+#include "LruCache.hpp"
+#include "Engine/CacheEngine.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+/* 字符串key的存储开销：单独的可执行文件，只有这里替换全局operator new统计堆分配，
+   不影响MyCacheBench中其他性能测试的计时。按缓存行对齐的节点走posix_memalign，不计入统计。 */
+namespace
+{
+    size_t allocationCount = 0;
+    size_t allocationBytes = 0;
+}
+
+// 不内联，避免编译器把free和new表达式放在一起看而误报不匹配
+__attribute__((noinline)) void *operator new(size_t size)
+{
+    allocationCount++;
+    allocationBytes += size;
+    if (void *ptr = std::malloc(size > 0 ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept { std::free(ptr); }
+__attribute__((noinline)) void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+void printThroughput(const std::string &name, int threads, long long ops, double seconds)
+{
+    std::cout << std::left << std::setw(16) << name
+              << " 线程数: " << std::setw(3) << threads
+              << " 吞吐量: " << std::fixed << std::setprecision(2)
+              << ops / seconds / 1e6 << " Mops/s" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== 性能测试8：字符串key的存储开销 ===" << std::endl;
+
+    const int KEYS = 100000;
+    std::vector<std::string> keys;
+    keys.reserve(KEYS);
+    char buffer[32];
+    for (int i = 0; i < KEYS; ++i)
+    {
+        std::snprintf(buffer, sizeof(buffer), "user:session:%08d", i); // 21字节，超出std::string的SSO
+        keys.push_back(buffer);
+    }
+
+    auto measure = [&](const std::string &name, auto makeCache)
+    {
+        size_t countBefore = allocationCount;
+        size_t bytesBefore = allocationBytes;
+        auto cache = makeCache();
+        for (int i = 0; i < KEYS; ++i)
+            cache->put(keys[i], i);
+        size_t count = allocationCount - countBefore;
+        size_t bytes = allocationBytes - bytesBefore;
+
+        int value = 0;
+        long long hits = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < KEYS; ++i)
+                hits += cache->get(keys[i], value);
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout << std::left << std::setw(20) << name
+                  << " 每条目分配次数: " << std::fixed << std::setprecision(2) << static_cast<double>(count) / KEYS
+                  << " 每条目字节数: " << std::setw(7) << static_cast<double>(bytes) / KEYS
+                  << " 命中: " << hits << " ";
+        printThroughput("get", 1, 10LL * KEYS, std::chrono::duration<double>(end - begin).count());
+    };
+
+    measure("LruCache<string>", [&]()
+            { return std::unique_ptr<MyCache::LruCache<std::string, int>>(new MyCache::LruCache<std::string, int>(KEYS)); });
+    measure("EngineLru<string>", [&]()
+            { return std::unique_ptr<MyCache::EngineLruCache<std::string, int>>(new MyCache::EngineLruCache<std::string, int>(KEYS)); });
+    measure("CompactLruCache", [&]()
+            { return std::unique_ptr<MyCache::CompactLruCache<int>>(new MyCache::CompactLruCache<int>(KEYS)); });
+    measure("CompactLfuCache", [&]()
+            { return std::unique_ptr<MyCache::CompactLfuCache<int>>(new MyCache::CompactLfuCache<int>(KEYS)); });
+    return 0;
+}
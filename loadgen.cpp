@@ -0,0 +1,484 @@
+#include "Simulator/Workloads.hpp"
+#include "Distributed/DistributedCache.hpp"
+#include "Distributed/MemcacheNode.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// memcached文本协议的压测客户端：Zipf分布的key，get/set混合，每个连接一次发出pipeline个请求再统一读回复
+
+struct LoadOptions
+{
+    std::string host = "127.0.0.1";
+    int port = 11211;
+    int threads = 4;
+    int connections = 4; // 每个线程的连接数
+    uint64_t keys = 100000;
+    double skew = 0.99;
+    uint64_t ops = 200000; // 每个线程的请求数
+    double getRatio = 0.9;
+    int batch = 1;     // 每个get请求的key数
+    int pipeline = 16; // 每个连接每轮发出的请求数
+    size_t valueSize = 100;
+    bool preload = false;
+    std::vector<int> nodePorts; // 非空时按一致性哈希把key分到这些端口上的服务
+};
+
+struct LoadStats
+{
+    uint64_t requests = 0;
+    uint64_t getKeys = 0;
+    uint64_t hits = 0;
+    uint64_t errors = 0; // 回复格式错误或value与写入的不一致
+    std::vector<long long> latencies; // 每轮往返耗时(微秒)
+};
+
+// 用法说明
+void printUsage(const char *program)
+{
+    std::cerr << "用法:\n"
+              << "  " << program << " [--host 127.0.0.1] [--port 11211] [--threads 4] [--connections 4]\n"
+              << "        [--keys 100000] [--skew 0.99] [--ops 每线程请求数] [--get-ratio 0.9]\n"
+              << "        [--batch 每个get的key数] [--pipeline 16] [--value-size 100] [--preload]\n"
+              << "        [--nodes 11211,11212,...]\n"
+              << "--preload先把所有key写入一遍，命中的value会与写入的内容核对。\n"
+              << "--nodes按一致性哈希把key分到本机多个端口的服务上，get按节点分组批量读取，未命中时写回；此时忽略--pipeline和--preload。" << std::endl;
+}
+
+std::string keyName(uint64_t key)
+{
+    return "key:" + std::to_string(key);
+}
+
+// value由key决定，读到时可以直接核对
+std::string valueOf(uint64_t key, size_t size)
+{
+    std::string pattern = std::to_string(key) + ';';
+    std::string value;
+    value.reserve(size);
+    while (value.size() < size)
+        value.append(pattern, 0, std::min(pattern.size(), size - value.size()));
+    return value;
+}
+
+int connectTo(const LoadOptions &options)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (::inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1 ||
+        ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    int on = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+bool sendAll(int fd, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+// 阻塞地按行或按字节数读取回复
+class ResponseReader
+{
+public:
+    explicit ResponseReader(int fd) : fd_(fd), begin_(0) {}
+
+    bool readLine(std::string &line)
+    {
+        while (true)
+        {
+            size_t pos = buffer_.find("\r\n", begin_);
+            if (pos != std::string::npos)
+            {
+                line.assign(buffer_, begin_, pos - begin_);
+                begin_ = pos + 2;
+                return true;
+            }
+            if (!fill())
+                return false;
+        }
+    }
+
+    bool readBytes(size_t size, std::string &data)
+    {
+        while (buffer_.size() - begin_ < size)
+        {
+            if (!fill())
+                return false;
+        }
+        data.assign(buffer_, begin_, size);
+        begin_ += size;
+        return true;
+    }
+
+private:
+    bool fill()
+    {
+        buffer_.erase(0, begin_);
+        begin_ = 0;
+        char chunk[16 * 1024];
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            return false;
+        buffer_.append(chunk, n);
+        return true;
+    }
+
+    int fd_;
+    std::string buffer_;
+    size_t begin_;
+};
+
+// 读一个get的回复直到END，返回false表示连接出错
+bool readGetResponse(ResponseReader &reader, const LoadOptions &options, LoadStats &stats)
+{
+    std::string line, data;
+    while (reader.readLine(line))
+    {
+        if (line == "END")
+            return true;
+        // VALUE <key> <flags> <bytes>
+        char key[256];
+        unsigned flags;
+        size_t bytes;
+        if (std::sscanf(line.c_str(), "VALUE %255s %u %zu", key, &flags, &bytes) != 3 || !reader.readBytes(bytes + 2, data))
+        {
+            stats.errors++;
+            return false;
+        }
+        stats.hits++;
+        uint64_t id = std::strtoull(key + 4, nullptr, 10);
+        if (data.compare(0, bytes, valueOf(id, options.valueSize)) != 0)
+            stats.errors++;
+    }
+    return false;
+}
+
+void runClient(const LoadOptions &options, int threadIndex, LoadStats &stats, std::atomic<bool> &failed)
+{
+    std::vector<int> fds;
+    std::vector<ResponseReader> readers;
+    for (int c = 0; c < options.connections; ++c)
+    {
+        int fd = connectTo(options);
+        if (fd < 0)
+        {
+            failed = true;
+            break;
+        }
+        fds.push_back(fd);
+        readers.emplace_back(fd);
+    }
+
+    MyCache::ZipfGenerator zipf(options.keys, options.skew, UINT64_MAX, threadIndex + 1);
+    std::mt19937_64 gen(threadIndex + 1000);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<bool> isGet;
+    std::string request;
+    uint64_t remaining = failed ? 0 : options.ops;
+
+    while (remaining > 0)
+    {
+        for (size_t c = 0; c < fds.size(); ++c)
+        {
+            if (remaining == 0)
+                break;
+            // 一轮：发出pipeline个请求，再按顺序读回所有回复
+            int count = static_cast<int>(std::min<uint64_t>(options.pipeline, remaining));
+            remaining -= count;
+            request.clear();
+            isGet.clear();
+            for (int i = 0; i < count; ++i)
+            {
+                uint64_t key = 0; // 生成器的总数是UINT64_MAX，next不会返回false
+                zipf.next(key);
+                if (uniform(gen) < options.getRatio)
+                {
+                    request += "get";
+                    for (int b = 0; b < options.batch; ++b)
+                    {
+                        if (b > 0)
+                        {
+                            zipf.next(key);
+                        }
+                        request += ' ';
+                        request += keyName(key);
+                    }
+                    request += "\r\n";
+                    isGet.push_back(true);
+                }
+                else
+                {
+                    request += "set " + keyName(key) + " 0 0 " + std::to_string(options.valueSize) + "\r\n";
+                    request += valueOf(key, options.valueSize);
+                    request += "\r\n";
+                    isGet.push_back(false);
+                }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            ResponseReader &reader = readers[c];
+            bool ok = sendAll(fds[c], request);
+            std::string line;
+            for (size_t i = 0; ok && i < isGet.size(); ++i)
+            {
+                if (isGet[i])
+                {
+                    stats.getKeys += options.batch;
+                    ok = readGetResponse(reader, options, stats);
+                }
+                else
+                {
+                    ok = reader.readLine(line);
+                    if (ok && line != "STORED")
+                        stats.errors++;
+                }
+            }
+            if (!ok)
+            {
+                failed = true;
+                remaining = 0;
+                break;
+            }
+            stats.requests += count;
+            stats.latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    for (int fd : fds)
+        ::close(fd);
+}
+
+// 多节点模式：每个线程自己建一个一致性哈希环，节点名为host:port，所有线程得到同样的映射
+void runRingClient(const LoadOptions &options, int threadIndex, LoadStats &stats, std::atomic<bool> &failed)
+{
+    MyCache::DistributedCache<std::string, std::string> cache;
+    for (int port : options.nodePorts)
+        cache.addNode(options.host + ":" + std::to_string(port), std::make_shared<MyCache::MemcacheNode>(options.host, port));
+
+    MyCache::ZipfGenerator zipf(options.keys, options.skew, UINT64_MAX, threadIndex + 1);
+    std::mt19937_64 gen(threadIndex + 1000);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<uint64_t> ids;
+    std::vector<std::string> keys, values;
+    std::vector<bool> found;
+
+    for (uint64_t op = 0; op < options.ops; ++op)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ids.clear();
+        keys.clear();
+        uint64_t key = 0;
+        bool isGet = uniform(gen) < options.getRatio;
+        for (int b = 0; b < (isGet ? options.batch : 1); ++b)
+        {
+            zipf.next(key);
+            ids.push_back(key);
+            keys.push_back(keyName(key));
+        }
+        if (isGet)
+        {
+            cache.multiGet(keys, values, found);
+            stats.getKeys += keys.size();
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                if (!found[i])
+                {
+                    cache.put(keys[i], valueOf(ids[i], options.valueSize));
+                    continue;
+                }
+                stats.hits++;
+                if (values[i] != valueOf(ids[i], options.valueSize))
+                    stats.errors++;
+            }
+        }
+        else
+        {
+            cache.put(keys[0], valueOf(ids[0], options.valueSize));
+        }
+        stats.requests++;
+        stats.latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    // 连接失败时MemcacheNode按未命中处理，全部未命中说明节点不可用
+    if (stats.getKeys > 0 && stats.hits == 0)
+        failed = true;
+}
+
+// 按线程划分key空间，每个线程用一个连接把自己那部分key写一遍
+bool preload(const LoadOptions &options)
+{
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < options.threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            int fd = connectTo(options);
+            if (fd < 0)
+            {
+                failed = true;
+                return;
+            }
+            ResponseReader reader(fd);
+            std::string request, line;
+            const uint64_t kChunk = 256;
+            for (uint64_t key = t; key < options.keys && !failed; key += kChunk * options.threads)
+            {
+                request.clear();
+                uint64_t count = 0;
+                for (uint64_t k = key; k < options.keys && count < kChunk; k += options.threads, ++count)
+                    request += "set " + keyName(k) + " 0 0 " + std::to_string(options.valueSize) + "\r\n" + valueOf(k, options.valueSize) + "\r\n";
+                if (!sendAll(fd, request))
+                    failed = true;
+                for (uint64_t i = 0; i < count && !failed; ++i)
+                {
+                    if (!reader.readLine(line) || line != "STORED")
+                        failed = true;
+                }
+            }
+            ::close(fd); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    return !failed;
+}
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc)
+            options.host = argv[++i];
+        else if (arg == "--port" && i + 1 < argc)
+            options.port = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--connections" && i + 1 < argc)
+            options.connections = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--keys" && i + 1 < argc)
+            options.keys = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        else if (arg == "--skew" && i + 1 < argc)
+            options.skew = std::atof(argv[++i]);
+        else if (arg == "--ops" && i + 1 < argc)
+            options.ops = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--get-ratio" && i + 1 < argc)
+            options.getRatio = std::atof(argv[++i]);
+        else if (arg == "--batch" && i + 1 < argc)
+            options.batch = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--pipeline" && i + 1 < argc)
+            options.pipeline = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--value-size" && i + 1 < argc)
+            options.valueSize = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--preload")
+            options.preload = true;
+        else if (arg == "--nodes" && i + 1 < argc)
+        {
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ','))
+            {
+                if (std::atoi(item.c_str()) > 0)
+                    options.nodePorts.push_back(std::atoi(item.c_str()));
+            }
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    bool ringMode = !options.nodePorts.empty();
+    if (options.preload && !ringMode)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!preload(options))
+        {
+            std::cerr << "预热失败，请确认服务已在 " << options.host << ":" << options.port << " 启动" << std::endl;
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "预热 " << options.keys << " 个key，用时 " << std::fixed << std::setprecision(2) << seconds << " 秒" << std::endl;
+    }
+
+    std::vector<LoadStats> stats(options.threads);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < options.threads; ++t)
+        workers.emplace_back([&, t]()
+                             {
+            if (ringMode)
+                runRingClient(options, t, stats[t], failed);
+            else
+                runClient(options, t, stats[t], failed); });
+    for (auto &worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failed)
+    {
+        std::cerr << "连接失败或被服务端关闭，请确认服务已启动" << std::endl;
+        return 1;
+    }
+
+    LoadStats total;
+    for (auto &s : stats)
+    {
+        total.requests += s.requests;
+        total.getKeys += s.getKeys;
+        total.hits += s.hits;
+        total.errors += s.errors;
+        total.latencies.insert(total.latencies.end(), s.latencies.begin(), s.latencies.end());
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+    auto percentile = [&](double p)
+    {
+        return total.latencies.empty() ? 0 : total.latencies[static_cast<size_t>(p * (total.latencies.size() - 1))];
+    };
+
+    std::cout << std::fixed << std::setprecision(2) << "线程: " << options.threads;
+    if (ringMode)
+        std::cout << " 节点: " << options.nodePorts.size();
+    else
+        std::cout << " 连接: " << options.threads * options.connections << " pipeline: " << options.pipeline;
+    std::cout << " 每个get的key数: " << options.batch << std::endl
+              << "请求数: " << total.requests << " 用时: " << seconds << " 秒 吞吐: " << total.requests / seconds / 1e3 << " K请求/秒" << std::endl
+              << "get命中率: " << (total.getKeys ? 100.0 * total.hits / total.getKeys : 0.0) << "% (" << total.hits << "/" << total.getKeys << ")"
+              << " 错误: " << total.errors << std::endl
+              << "每轮往返 p50: " << percentile(0.50) << " us p99: " << percentile(0.99) << " us p99.9: " << percentile(0.999) << " us" << std::endl;
+    return total.errors == 0 ? 0 : 2;
+}
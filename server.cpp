@@ -0,0 +1,82 @@
+#include "Server/MemcacheServer.hpp"
+
+#include <csignal>
+#include <pthread.h>
+#include <signal.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// 用法说明
+void printUsage(const char *program)
+{
+    std::cerr << "用法:\n"
+              << "  " << program << " [--host 127.0.0.1] [--port 11211] [--threads N] [--policy lru|lfu|arc]\n"
+              << "        [--capacity 条目数] [--slices N] [--max-item-size 字节数]\n"
+              << "以memcached文本协议(get/gets/set/delete)提供缓存服务，threads和slices为0时取CPU核数。" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::string host = "127.0.0.1";
+    int port = 11211;
+    int threads = 0;
+    std::string policy = "lru";
+    size_t capacity = 1000000;
+    int slices = 0;
+    size_t maxItemSize = 1 << 20;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc)
+            host = argv[++i];
+        else if (arg == "--port" && i + 1 < argc)
+            port = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (arg == "--policy" && i + 1 < argc)
+            policy = argv[++i];
+        else if (arg == "--capacity" && i + 1 < argc)
+            capacity = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--slices" && i + 1 < argc)
+            slices = std::atoi(argv[++i]);
+        else if (arg == "--max-item-size" && i + 1 < argc)
+            maxItemSize = std::strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::unique_ptr<MyCache::CacheBackend> backend = MyCache::makeCacheBackend(policy, capacity, slices);
+    if (!backend || capacity == 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 事件循环线程继承这里的信号屏蔽，SIGINT/SIGTERM只由主线程的sigwait接收
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    MyCache::MemcacheServer server(std::move(backend), maxItemSize);
+    if (!server.start(host, port, threads))
+    {
+        std::cerr << "无法监听 " << host << ":" << port << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "MyCache服务已启动: " << host << ":" << port << "，策略 " << policy << "，容量 " << capacity << std::endl;
+
+    int received = 0;
+    sigwait(&signals, &received);
+    std::cout << "收到信号 " << received << "，正在退出" << std::endl;
+    server.stop();
+    return 0;
+}
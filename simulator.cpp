@@ -0,0 +1,117 @@
+#include "Simulator/CacheSimulator.hpp"
+#include "Simulator/DefaultPolicies.hpp"
+#include "Simulator/TraceReader.hpp"
+#include "Simulator/Workloads.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 用法说明
+void printUsage(const char *program)
+{
+    std::cerr << "用法:\n"
+              << "  " << program << " --trace <文件> [--format binary|arc|lirs] --capacities 100,1000,... [--csv]\n"
+              << "  " << program << " --zipf <key数量> <倾斜度> <访问次数> --capacities 100,1000,... [--csv]\n"
+              << "对每个策略和每个容量回放同一条访问序列，输出未命中率曲线。" << std::endl;
+}
+
+std::vector<int> parseCapacities(const std::string &text)
+{
+    std::vector<int> capacities;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        int capacity = std::atoi(item.c_str());
+        if (capacity > 0)
+            capacities.push_back(capacity);
+    }
+    return capacities;
+}
+
+int main(int argc, char **argv)
+{
+    std::string tracePath;
+    MyCache::TraceReader::Format format = MyCache::TraceReader::Format::Binary;
+    bool useZipf = false;
+    uint64_t zipfKeys = 0, zipfCount = 0;
+    double zipfSkew = 0;
+    std::vector<int> capacities;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            if (!MyCache::TraceReader::parseFormat(argv[++i], format))
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (arg == "--zipf" && i + 3 < argc)
+        {
+            useZipf = true;
+            zipfKeys = std::strtoull(argv[++i], nullptr, 10);
+            zipfSkew = std::atof(argv[++i]);
+            zipfCount = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--capacities" && i + 1 < argc)
+        {
+            capacities = parseCapacities(argv[++i]);
+        }
+        else if (arg == "--csv")
+        {
+            csv = true;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((tracePath.empty() && !useZipf) || capacities.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    MyCache::CacheSimulator::StreamFactory makeStream;
+    if (useZipf)
+    {
+        makeStream = [=]()
+        {
+            return std::unique_ptr<MyCache::AccessStream>(new MyCache::ZipfGenerator(zipfKeys, zipfSkew, zipfCount));
+        };
+    }
+    else
+    {
+        if (!MyCache::TraceReader(tracePath, format).valid())
+        {
+            std::cerr << "无法读取轨迹文件: " << tracePath << std::endl;
+            return 1;
+        }
+        makeStream = [=]()
+        {
+            return std::unique_ptr<MyCache::AccessStream>(new MyCache::TraceReader(tracePath, format));
+        };
+    }
+
+    MyCache::CacheSimulator simulator;
+    MyCache::addDefaultPolicies(simulator);
+    auto results = simulator.run(makeStream, capacities);
+    if (csv)
+        MyCache::CacheSimulator::writeCsv(std::cout, results);
+    else
+        MyCache::CacheSimulator::printCurves(std::cout, results);
+    return 0;
+}
@@ -1,6 +1,21 @@
 #include "LruCache.hpp"
 #include "LfuCache.hpp"
 #include "ArcCache/ArcCache.hpp"
+#include "LirsCache.hpp"
+#include "SlruCache.hpp"
+#include "GdsfCache.hpp"
+#include "SampledLfuCache.hpp"
+#include "ShardsTracker.hpp"
+#include "Engine/CacheEngine.hpp"
+#include "ConcurrentLruCache.hpp"
+#include "NearCache.hpp"
+#include "PerThreadCache.hpp"
+#include "CompressedCache.hpp"
+#include "TaggedCache.hpp"
+#include "RefreshAheadCache.hpp"
+#include "Simulator/CacheSimulator.hpp"
+#include "Simulator/DefaultPolicies.hpp"
+#include "Simulator/Workloads.hpp"
 #include "CachePolicy.h"
 
 #include <iostream>
@@ -10,26 +25,30 @@
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <thread>
+#include <atomic>
 
 // 辅助函数：打印结果
 void printResults(const std::string &testName, int capacity,
                   const std::vector<int> &get_operations,
-                  const std::vector<int> &hits)
+                  const std::vector<int> &hits,
+                  std::vector<std::string> names = {})
 {
     std::cout << "=== " << testName << " 结果汇总 ===" << std::endl;
     std::cout << "缓存大小: " << capacity << std::endl;
 
-    // 假设对应的算法名称已在测试函数中定义
-    std::vector<std::string> names;
-    if (hits.size() == 3)
+    // 未指定名称时按默认的算法顺序
+    if (names.empty() && hits.size() == 3)
     {
         names = {"LRU", "LFU", "ARC"};
     }
-    else if (hits.size() == 4)
+    else if (names.empty() && hits.size() == 4)
     {
         names = {"LRU", "LFU", "ARC", "LRU-K"};
     }
-    else if (hits.size() == 5)
+    else if (names.empty() && hits.size() == 5)
     {
         names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
     }
@@ -65,15 +84,16 @@ void testHotDataAccess()
     // - k=2表示数据被访问2次后才会进入缓存，适合区分热点和冷数据
     MyCache::LruKCache<int, std::string> lruk(CAPACITY, HOT_KEYS + COLD_KEYS, 2);
     MyCache::LfuCache<int, std::string> lfuAging(CAPACITY, 20000);
+    MyCache::LirsCache<int, std::string> lirs(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
     // 基类指针指向派生类对象，添加LFU-Aging
-    std::array<MyCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    std::vector<int> hits(5, 0);
-    std::vector<int> get_operations(5, 0);
-    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
+    std::array<MyCache::CachePolicy<int, std::string> *, 6> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lirs};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging", "LIRS"};
 
     // 为所有的缓存对象进行相同的操作序列测试
     for (int i = 0; i < caches.size(); ++i)
@@ -123,7 +143,7 @@ void testHotDataAccess()
     }
 
     // 打印测试结果
-    printResults("热点数据访问测试", CAPACITY, get_operations, hits);
+    printResults("热点数据访问测试", CAPACITY, get_operations, hits, names);
 }
 
 void testLoopPattern()
@@ -142,11 +162,12 @@ void testLoopPattern()
     // - k=2，对于循环访问，这是一个合理的阈值
     MyCache::LruKCache<int, std::string> lruk(CAPACITY, LOOP_SIZE * 2, 2);
     MyCache::LfuCache<int, std::string> lfuAging(CAPACITY, 3000);
+    MyCache::LirsCache<int, std::string> lirs(CAPACITY);
 
-    std::array<MyCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    std::vector<int> hits(5, 0);
-    std::vector<int> get_operations(5, 0);
-    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
+    std::array<MyCache::CachePolicy<int, std::string> *, 6> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lirs};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging", "LIRS"};
 
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -205,7 +226,7 @@ void testLoopPattern()
         }
     }
 
-    printResults("循环扫描测试", CAPACITY, get_operations, hits);
+    printResults("循环扫描测试", CAPACITY, get_operations, hits, names);
 }
 
 void testWorkloadShift()
@@ -221,13 +242,14 @@ void testWorkloadShift()
     MyCache::ArcCache<int, std::string> arc(CAPACITY);
     MyCache::LruKCache<int, std::string> lruk(CAPACITY, 500, 2);
     MyCache::LfuCache<int, std::string> lfuAging(CAPACITY, 10000);
+    MyCache::LirsCache<int, std::string> lirs(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::array<MyCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    std::vector<int> hits(5, 0);
-    std::vector<int> get_operations(5, 0);
-    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
+    std::array<MyCache::CachePolicy<int, std::string> *, 6> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lirs};
+    std::vector<int> hits(6, 0);
+    std::vector<int> get_operations(6, 0);
+    std::vector<std::string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging", "LIRS"};
 
     // 为每种缓存算法运行相同的测试
     for (int i = 0; i < caches.size(); ++i)
@@ -327,14 +349,1069 @@ void testWorkloadShift()
         }
     }
 
-    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits);
+    printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits, names);
 }
 
+void testSkewedSlices()
+{
+    std::cout << "\n=== 测试场景4：分片负载倾斜测试 ===" << std::endl;
+
+    const int CAPACITY = 400;      // 总缓存容量
+    const int SLICE_NUM = 4;       // 分片数量
+    const int OPERATIONS = 300000; // 总操作次数
+    const int HOT_KEYS = 300;      // 热点数据数量，全部落在同一个分片
+    const int COLD_KEYS = 20000;   // 冷数据数量
+
+    MyCache::LfuCache<int, std::string> globalLfu(CAPACITY);
+    MyCache::HashLfuCache<int, std::string> fixedLfu(CAPACITY, SLICE_NUM, 1000000);
+    MyCache::HashLfuCache<int, std::string> rebalancedLfu(CAPACITY, SLICE_NUM, 1000000);
+    rebalancedLfu.setAutoRebalanceInterval(2000);
+    MyCache::HashLfuCache<int, std::string> grownLfu(CAPACITY, SLICE_NUM, 1000000);
+    grownLfu.setMaxSliceNum(SLICE_NUM * 2);
+    grownLfu.setAutoRebalanceInterval(2000);
+
+    std::vector<std::string> names = {"LFU(不分片)", "HashLFU", "HashLFU-Rebalance", "HashLFU-Grow"};
+    std::vector<int> hits(4, 0);
+    std::vector<int> get_operations(4, 0);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    auto run = [&](int index, auto &cache, std::function<void()> grow)
+    {
+        for (int op = 0; op < OPERATIONS; ++op)
+        {
+            // 运行过程中逐个分裂分片，数据在新分片未命中时惰性迁移
+            if (grow && op % (OPERATIONS / 8) == 0 && op > 0)
+                grow();
+
+            bool isPut = (gen() % 100 < 20);
+            int key;
+            // std::hash<int>是恒等映射，4的倍数全部落在0号分片
+            if (gen() % 100 < 70)
+                key = (gen() % HOT_KEYS) * SLICE_NUM;
+            else
+                key = gen() % COLD_KEYS;
+
+            if (isPut)
+            {
+                cache.put(key, "value" + std::to_string(key));
+            }
+            else
+            {
+                std::string result;
+                get_operations[index]++;
+                if (cache.get(key, result))
+                    hits[index]++;
+            }
+        }
+    };
+    run(0, globalLfu, nullptr);
+    run(1, fixedLfu, nullptr);
+    run(2, rebalancedLfu, nullptr);
+    run(3, grownLfu, [&]()
+        { grownLfu.grow(); });
+
+    printResults("分片负载倾斜测试", CAPACITY, get_operations, hits, names);
+    std::cout << "HashLFU-Rebalance 各分片容量:";
+    for (int i = 0; i < SLICE_NUM; ++i)
+        std::cout << " " << rebalancedLfu.getSliceCapacity(i);
+    std::cout << std::endl;
+}
+
+void testSampledLfu()
+{
+    std::cout << "\n=== 测试场景5：采样近似LFU与精确LFU对比 ===" << std::endl;
+
+    const int CAPACITY = 500;      // 缓存容量
+    const int OPERATIONS = 500000; // 总操作次数
+    const int HOT_KEYS = 400;      // 热点数据数量
+    const int COLD_KEYS = 50000;   // 冷数据数量
+
+    MyCache::LfuCache<int, std::string> lfu(CAPACITY);
+    MyCache::SampledLfuCache<int, std::string> sampled5(CAPACITY, 5);
+    MyCache::SampledLfuCache<int, std::string> sampled10(CAPACITY, 10);
+
+    std::array<MyCache::CachePolicy<int, std::string> *, 3> caches = {&lfu, &sampled5, &sampled10};
+    std::vector<std::string> names = {"LFU", "SampledLFU(5)", "SampledLFU(10)"};
+    std::vector<int> hits(3, 0);
+    std::vector<int> get_operations(3, 0);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    for (int i = 0; i < caches.size(); ++i)
+    {
+        for (int op = 0; op < OPERATIONS; ++op)
+        {
+            bool isPut = (gen() % 100 < 20);
+            int key;
+            // 热点内部也有冷热之分：前1/4热点键的访问概率更高
+            int r = gen() % 100;
+            if (r < 40)
+                key = gen() % (HOT_KEYS / 4);
+            else if (r < 75)
+                key = gen() % HOT_KEYS;
+            else
+                key = HOT_KEYS + gen() % COLD_KEYS;
+
+            if (isPut)
+            {
+                caches[i]->put(key, "value" + std::to_string(key));
+            }
+            else
+            {
+                std::string result;
+                get_operations[i]++;
+                if (caches[i]->get(key, result))
+                    hits[i]++;
+            }
+        }
+    }
+
+    printResults("采样近似LFU对比测试", CAPACITY, get_operations, hits, names);
+    std::cout << "SampledLFU 每条目元数据: " << MyCache::SampledLfuCache<int, std::string>::metadataBytes() << " 字节" << std::endl;
+}
+
+void testMissRatioCurves()
+{
+    std::cout << "\n=== 测试场景6：未命中率曲线(模拟器) ===" << std::endl;
+
+    const std::vector<int> CAPACITIES = {50, 200, 1000, 4000};
+    const uint64_t KEYS = 20000;
+    const uint64_t OPERATIONS = 200000;
+
+    MyCache::CacheSimulator simulator;
+    MyCache::addDefaultPolicies(simulator);
+
+    std::cout << "--- Zipf分布(倾斜度0.9) ---" << std::endl;
+    auto zipf = [&]()
+    {
+        return std::unique_ptr<MyCache::AccessStream>(new MyCache::ZipfGenerator(KEYS, 0.9, OPERATIONS, 7));
+    };
+    MyCache::CacheSimulator::printCurves(std::cout, simulator.run(zipf, CAPACITIES));
+
+    std::cout << "--- 工作负载切换(热点 -> 循环扫描 -> 均匀随机) ---" << std::endl;
+    auto phased = [&]()
+    {
+        std::unique_ptr<MyCache::PhasedWorkload> workload(new MyCache::PhasedWorkload());
+        workload->addPhase(std::unique_ptr<MyCache::AccessStream>(new MyCache::HotColdGenerator(100, KEYS, 80, OPERATIONS / 3, 7)))
+            .addPhase(std::unique_ptr<MyCache::AccessStream>(new MyCache::LoopGenerator(2000, OPERATIONS / 3)))
+            .addPhase(std::unique_ptr<MyCache::AccessStream>(new MyCache::UniformGenerator(KEYS, OPERATIONS / 3, 7)));
+        return std::unique_ptr<MyCache::AccessStream>(std::move(workload));
+    };
+    MyCache::CacheSimulator::printCurves(std::cout, simulator.run(phased, CAPACITIES));
+}
+
+void testShardsTracker()
+{
+    std::cout << "\n=== 测试场景7：在线未命中率曲线估计(SHARDS) ===" << std::endl;
+
+    const std::vector<int> CAPACITIES = {500, 2000, 10000, 40000};
+    const uint64_t KEYS = 100000;
+    const uint64_t OPERATIONS = 500000;
+    const int LIVE_CAPACITY = 10000;
+
+    // 精确值：模拟器逐个容量回放
+    MyCache::CacheSimulator simulator;
+    simulator.addPolicy("LRU", [](int capacity)
+                        { return std::unique_ptr<MyCache::CacheSimulator::Cache>(new MyCache::LruCache<uint64_t, uint64_t>(capacity)); });
+    auto exact = simulator.run([&]()
+                               { return std::unique_ptr<MyCache::AccessStream>(new MyCache::ZipfGenerator(KEYS, 0.9, OPERATIONS, 7)); },
+                               CAPACITIES);
+
+    // 估计值：只运行一个容量为LIVE_CAPACITY的缓存，由挂接的估计器推算其他容量
+    auto fixedRate = std::make_shared<MyCache::ShardsTracker<uint64_t>>(0.01, 10);
+    auto fixedSize = std::make_shared<MyCache::ShardsTracker<uint64_t>>(1.0, 10, 1 << 22, 2048);
+    MyCache::LruCache<uint64_t, uint64_t> lru(LIVE_CAPACITY);
+    MyCache::ArcCache<uint64_t, uint64_t> arc(LIVE_CAPACITY);
+    lru.setMissRatioTracker(fixedRate);
+    arc.setMissRatioTracker(fixedSize);
+    MyCache::ZipfGenerator stream(KEYS, 0.9, OPERATIONS, 7);
+    uint64_t key, value;
+    while (stream.next(key))
+    {
+        if (!lru.get(key, value))
+            lru.put(key, key);
+        if (!arc.get(key, value))
+            arc.put(key, key);
+    }
+
+    std::cout << "固定采样率1%跟踪key数: " << fixedRate->sampledKeys()
+              << "，固定2048个key时的采样率: " << std::fixed << std::setprecision(4) << fixedSize->sampleRate() << std::endl;
+    std::cout << std::left << std::setw(10) << "容量" << std::setw(12) << "精确LRU"
+              << std::setw(12) << "R=0.01" << std::setw(12) << "Smax=2048" << std::endl;
+    for (size_t i = 0; i < CAPACITIES.size(); ++i)
+    {
+        size_t capacity = CAPACITIES[i];
+        std::cout << std::setw(10) << capacity << std::setw(12) << exact[i].missRatio()
+                  << std::setw(12) << 1.0 - fixedRate->estimateHitRate(capacity)
+                  << std::setw(12) << 1.0 - fixedSize->estimateHitRate(capacity) << std::endl;
+    }
+}
+
+void testCacheEngine()
+{
+    std::cout << "\n=== 测试场景8：策略组合引擎(CacheEngine) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const uint64_t KEYS = 20000;
+    const uint64_t OPERATIONS = 200000;
+    const int MAX_AVERAGE_NUM = 1000000; // 关闭老化，与引擎的LFU语义一致
+
+    MyCache::LruCache<uint64_t, uint64_t> lru(CAPACITY);
+    MyCache::LfuCache<uint64_t, uint64_t> lfu(CAPACITY, MAX_AVERAGE_NUM);
+    MyCache::EngineLruCache<uint64_t, uint64_t, MyCache::NullLock, MyCache::CountingStats> engineLru(CAPACITY);
+    MyCache::EngineLfuCache<uint64_t, uint64_t, MyCache::NullLock, MyCache::CountingStats> engineLfu(CAPACITY);
+
+    std::vector<int> hits(4, 0);
+    std::vector<int> get_operations(4, 0);
+    auto access = [&](auto &cache, size_t index, uint64_t key)
+    {
+        uint64_t value;
+        get_operations[index]++;
+        if (cache.get(key, value))
+            hits[index]++;
+        else
+            cache.put(key, key);
+    };
+
+    MyCache::ZipfGenerator stream(KEYS, 0.9, OPERATIONS, 7);
+    uint64_t key;
+    while (stream.next(key))
+    {
+        access(lru, 0, key);
+        access(lfu, 1, key);
+        access(engineLru, 2, key);
+        access(engineLfu, 3, key);
+    }
+
+    printResults("策略组合引擎", CAPACITY, get_operations, hits,
+                 {"LruCache", "LfuCache", "CacheEngine<LRU>", "CacheEngine<LFU>"});
+    std::cout << "CacheEngine<LRU> 统计: 命中 " << engineLru.stats().hits << " 未命中 " << engineLru.stats().misses
+              << " 淘汰 " << engineLru.stats().evictions << std::endl;
+}
+
+void testConcurrentLru()
+{
+    std::cout << "\n=== 测试场景9：读无锁的近似LRU(ConcurrentLruCache) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const uint64_t KEYS = 20000;
+    const uint64_t OPERATIONS = 200000;
+
+    MyCache::LruCache<uint64_t, uint64_t> lru(CAPACITY);
+    MyCache::ConcurrentLruCache<uint64_t, uint64_t> concurrentLru(CAPACITY);
+    std::array<MyCache::CachePolicy<uint64_t, uint64_t> *, 2> caches = {&lru, &concurrentLru};
+    std::vector<int> hits(2, 0);
+    std::vector<int> get_operations(2, 0);
+
+    MyCache::ZipfGenerator stream(KEYS, 0.9, OPERATIONS, 7);
+    uint64_t key, value;
+    while (stream.next(key))
+    {
+        for (size_t i = 0; i < caches.size(); ++i)
+        {
+            get_operations[i]++;
+            if (caches[i]->get(key, value))
+                hits[i]++;
+            else
+                caches[i]->put(key, key);
+        }
+    }
+
+    printResults("读无锁LRU", CAPACITY, get_operations, hits, {"LruCache", "ConcurrentLruCache"});
+
+    // ArcCache在多线程间共享：小容量下频繁命中幽灵表，两部分之间来回调整容量
+    MyCache::ArcCache<int, int> sharedArc(64);
+    std::atomic<int> wrongValues(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t)
+    {
+        workers.emplace_back([&sharedArc, &wrongValues, t]()
+                             {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<int> dist(0, 255);
+            int v;
+            for (int i = 0; i < 50000; ++i)
+            {
+                int k = dist(gen);
+                if (i % 2)
+                    sharedArc.put(k, k * 3);
+                else if (sharedArc.get(k, v) && v != k * 3)
+                    wrongValues++;
+            } });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    std::cout << "ArcCache 8线程共享读写: value错误 " << wrongValues.load() << " 次" << std::endl;
+}
+
+void testRefreshAhead()
+{
+    std::cout << "\n=== 测试场景10：热点key提前刷新(RefreshAheadCache) ===" << std::endl;
+
+    using Cache = MyCache::RefreshAheadCache<int, std::string>;
+    const int ACCESSES = 300;
+    const auto LOAD_TIME = std::chrono::milliseconds(5);
+    const auto REFRESH_AFTER = std::chrono::milliseconds(20);
+    const auto EXPIRE_AFTER = std::chrono::milliseconds(60);
+
+    std::atomic<int> backgroundLoads(0);
+    auto load = [&](const int &key, std::string &value)
+    {
+        std::this_thread::sleep_for(LOAD_TIME);
+        value = "value" + std::to_string(key);
+        return true;
+    };
+    auto backgroundLoad = [&](const int &key, std::string &value)
+    {
+        backgroundLoads++;
+        return load(key, value);
+    };
+
+    // 每毫秒访问一次同一个热点key，未命中时同步加载
+    auto run = [&](const std::string &name, Cache &cache)
+    {
+        backgroundLoads = 0;
+        int misses = 0;
+        long long maxLatency = 0;
+        for (int i = 0; i < ACCESSES; ++i)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            std::string value;
+            if (!cache.get(1, value))
+            {
+                misses++;
+                load(1, value);
+                cache.put(1, value);
+            }
+            auto end = std::chrono::steady_clock::now();
+            maxLatency = std::max<long long>(maxLatency, std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::cout << name << " - 同步未命中: " << misses << "，后台刷新: " << backgroundLoads.load()
+                  << "，最大延迟: " << maxLatency << " us" << std::endl;
+    };
+
+    auto executor = std::make_shared<MyCache::MaintenanceExecutor>(1);
+    {
+        Cache expireOnly(std::unique_ptr<Cache::InnerCache>(new MyCache::LruCache<int, Cache::Entry>(10)),
+                         backgroundLoad, std::chrono::milliseconds(0), executor, EXPIRE_AFTER);
+        run("LRU 仅过期", expireOnly);
+    }
+    {
+        Cache refreshLru(std::unique_ptr<Cache::InnerCache>(new MyCache::LruCache<int, Cache::Entry>(10)),
+                         backgroundLoad, REFRESH_AFTER, executor, EXPIRE_AFTER);
+        run("LRU 提前刷新", refreshLru);
+    }
+    {
+        Cache refreshArc(std::unique_ptr<Cache::InnerCache>(new MyCache::ArcCache<int, Cache::Entry>(10)),
+                         backgroundLoad, REFRESH_AFTER, executor, EXPIRE_AFTER);
+        run("ARC 提前刷新", refreshArc);
+    }
+
+    // 加载器卡住期间put新值，刷新完成后不能被加载出的旧值覆盖
+    {
+        const int ROUNDS = 20;
+        std::atomic<bool> loading(false), release(false);
+        auto slowLoad = [&](const int &key, std::string &value)
+        {
+            loading = true;
+            while (!release)
+                std::this_thread::yield();
+            value = "loaded" + std::to_string(key);
+            return true;
+        };
+        Cache cache(std::unique_ptr<Cache::InnerCache>(new MyCache::LruCache<int, Cache::Entry>(10)),
+                    slowLoad, std::chrono::milliseconds(1), executor);
+        int overwritten = 0;
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            loading = false;
+            release = false;
+            cache.put(1, "old");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::string value;
+            cache.get(1, value); // 超过刷新间隔，提交刷新
+            while (!loading)
+                std::this_thread::yield();
+            std::string fresh = "put" + std::to_string(round);
+            cache.put(1, fresh);
+            release = true;
+            while (cache.refreshingCount() != 0)
+                std::this_thread::yield();
+            cache.get(1, value);
+            overwritten += value != fresh;
+        }
+        std::cout << "刷新期间put - " << ROUNDS << " 轮中新值被刷新结果覆盖: " << overwritten << " 次" << std::endl;
+    }
+}
+
+void testScanResistance()
+{
+    std::cout << "\n=== 测试场景11：扫描抗性(SLRU/2Q) ===" << std::endl;
+
+    const int CAPACITY = 100;
+    const int HOT_KEYS = 80;       // 热点数据，能全部放进缓存
+    const int OPERATIONS = 200000;
+    const int SCAN_EVERY = 1000;   // 每1000次访问插入一次扫描
+    const int SCAN_LENGTH = 300;   // 每次扫描300个只访问一次的key
+
+    MyCache::LruCache<int, int> lru(CAPACITY);
+    MyCache::LruKCache<int, int> lruk(CAPACITY, CAPACITY * 4, 2);
+    MyCache::SlruCache<int, int> slru(CAPACITY);
+    MyCache::TwoQueueCache<int, int> twoQueue(CAPACITY, 0.25, 4.0); // A1out与LRU-K的历史记录一样记住4倍容量的key
+    std::array<MyCache::CachePolicy<int, int> *, 4> caches = {&lru, &lruk, &slru, &twoQueue};
+    std::vector<int> hits(4, 0);
+    std::vector<int> get_operations(4, 0);
+
+    for (size_t i = 0; i < caches.size(); ++i)
+    {
+        std::mt19937 gen(11);
+        int nextScanKey = HOT_KEYS;
+        for (int op = 0; op < OPERATIONS; ++op)
+        {
+            int key;
+            if (op % SCAN_EVERY < SCAN_LENGTH)
+                key = nextScanKey++; // 扫描：每个key只出现一次
+            else
+                key = gen() % HOT_KEYS;
+
+            int value;
+            get_operations[i]++;
+            if (caches[i]->get(key, value))
+                hits[i]++;
+            else
+                caches[i]->put(key, key);
+        }
+    }
+
+    printResults("扫描抗性测试", CAPACITY, get_operations, hits, {"LRU", "LRU-K", "SLRU", "2Q"});
+}
+
+void testSizeAwareEviction()
+{
+    std::cout << "\n=== 测试场景12：按大小和代价淘汰(GDSF) ===" << std::endl;
+
+    const uint64_t KEYS = 10000;
+    const int OPERATIONS = 200000;
+    const size_t BUDGET_KB = 64 * 1024; // 缓存总容量64MB，以KB计
+
+    // 每个key的大小和未命中代价固定：90%为1~4KB的小对象，10%为512KB~2MB的大对象；
+    // 20%的key重新加载代价高(50)，其余为1
+    auto sizeOf = [](uint64_t key) -> size_t
+    {
+        uint64_t h = MyCache::mixKey(key);
+        return h % 10 == 0 ? 512 + (h >> 8) % 1537 : 1 + (h >> 8) % 4;
+    };
+    auto costOf = [](uint64_t key) -> double
+    {
+        return (MyCache::mixKey(key) >> 20) % 5 == 0 ? 50.0 : 1.0;
+    };
+
+    size_t totalSize = 0;
+    for (uint64_t key = 0; key < KEYS; ++key)
+        totalSize += sizeOf(key);
+    // LRU只能按条目数限制容量，按平均大小换算
+    int lruCapacity = static_cast<int>(BUDGET_KB / (totalSize / KEYS));
+
+    MyCache::LruCache<uint64_t, uint64_t> lru(lruCapacity);
+    MyCache::GdsfCache<uint64_t, uint64_t> gdsf(BUDGET_KB);
+    std::vector<int> hits(2, 0);
+    std::vector<int> get_operations(2, 0);
+    std::vector<double> savedCost(2, 0.0);
+    double totalCost = 0;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        MyCache::ZipfGenerator zipf(KEYS, 0.9, OPERATIONS, 12);
+        uint64_t key;
+        while (zipf.next(key))
+        {
+            uint64_t value;
+            get_operations[i]++;
+            if (i == 0)
+                totalCost += costOf(key);
+            bool hit = i == 0 ? lru.get(key, value) : gdsf.get(key, value);
+            if (hit)
+            {
+                hits[i]++;
+                savedCost[i] += costOf(key);
+            }
+            else if (i == 0)
+                lru.put(key, key);
+            else
+                gdsf.put(key, key, sizeOf(key), costOf(key));
+        }
+    }
+
+    printResults("大小/代价感知测试", static_cast<int>(BUDGET_KB), get_operations, hits, {"LRU", "GDSF"});
+    std::cout << "LRU按平均大小换算的条目数: " << lruCapacity << "，GDSF常驻条目数: " << gdsf.size() << std::endl;
+    std::cout << "节省的加载代价: LRU " << std::fixed << std::setprecision(2) << 100.0 * savedCost[0] / totalCost
+              << "%，GDSF " << 100.0 * savedCost[1] / totalCost << "%" << std::endl;
+}
+
+void testNearCache()
+{
+    std::cout << "\n=== 测试场景13：线程局部L1近端缓存(NearCache) ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const uint64_t KEYS = 20000;
+    const uint64_t OPERATIONS = 200000;
+    const int READERS = 4;
+    const uint64_t HOT_KEYS = 16;
+
+    // 命中率：L1只是L2的副本，两级合起来的命中率应与单独使用L2一致
+    auto l2 = std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 4);
+    MyCache::HashLruCache<uint64_t, uint64_t> plain(CAPACITY, 4);
+    MyCache::NearCache<uint64_t, uint64_t> near(l2, 64);
+    std::vector<int> hits(2, 0);
+    std::vector<int> get_operations(2, 0);
+    MyCache::ZipfGenerator stream(KEYS, 0.9, OPERATIONS, 13);
+    uint64_t key, value;
+    while (stream.next(key))
+    {
+        get_operations[0]++;
+        get_operations[1]++;
+        if (plain.get(key, value))
+            hits[0]++;
+        else
+            plain.put(key, key);
+        if (near.get(key, value))
+            hits[1]++;
+        else
+            near.put(key, key);
+    }
+    printResults("近端缓存", CAPACITY, get_operations, hits, {"HashLruCache", "NearCache"});
+
+    // 一致性：写线程不断更新热点key，每次put返回后公布写入的值；
+    // 读线程先读公布的值再get，读到的值不能比它更旧
+    MyCache::NearCache<uint64_t, uint64_t> shared(std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 4), 64);
+    std::vector<std::atomic<uint64_t>> acknowledged(HOT_KEYS);
+    for (uint64_t k = 0; k < HOT_KEYS; ++k)
+    {
+        shared.put(k, 0);
+        acknowledged[k] = 0;
+    }
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> staleReads(0), reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < READERS; ++t)
+    {
+        readers.emplace_back([&, t]()
+                             {
+            uint64_t k = t, v;
+            while (!done.load())
+            {
+                k = (k + 1) % HOT_KEYS;
+                uint64_t floor = acknowledged[k].load();
+                if (!shared.get(k, v) || v < floor)
+                    staleReads++;
+                reads++;
+            } });
+    }
+    for (uint64_t version = 1; version <= 20000; ++version)
+    {
+        uint64_t k = version % HOT_KEYS;
+        shared.put(k, version);
+        acknowledged[k].store(version);
+    }
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+    std::cout << "并发读 " << reads.load() << " 次，读到早于已确认写入的值: " << staleReads.load() << " 次" << std::endl;
+
+    // 同一线程交替访问两个实例：各自的L1互不串用，每个线程在每个包装器里只登记一次
+    MyCache::NearCache<uint64_t, uint64_t> left(std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 4), 64);
+    MyCache::NearCache<uint64_t, uint64_t> right(std::make_shared<MyCache::HashLruCache<uint64_t, uint64_t>>(CAPACITY, 4), 64);
+    MyCache::PerThreadCache<MyCache::LruCache<uint64_t, uint64_t, MyCache::NullLock>> first(CAPACITY), second(CAPACITY);
+    int crossed = 0;
+    for (uint64_t k = 0; k < 1000; ++k)
+    {
+        left.put(k % HOT_KEYS, k);
+        right.put(k % HOT_KEYS, k + 1);
+        first.put(k % HOT_KEYS, k);
+        second.put(k % HOT_KEYS, k + 1);
+        if (!left.get(k % HOT_KEYS, value) || value != k || !right.get(k % HOT_KEYS, value) || value != k + 1)
+            crossed++;
+        if (!first.get(k % HOT_KEYS, value) || value != k || !second.get(k % HOT_KEYS, value) || value != k + 1)
+            crossed++;
+    }
+    std::cout << "交替访问两个实例: 读错 " << crossed << " 次，PerThreadCache实例数 " << first.instanceCount()
+              << "/" << second.instanceCount() << std::endl;
+}
+
+// 模拟业务中的JSON记录：字段名重复、取值随key变化，约1.5KB
+std::string makeJsonRecord(uint64_t id)
+{
+    uint64_t h = MyCache::mixKey(id);
+    std::string record = "{\"id\":" + std::to_string(id) + ",\"name\":\"user_" + std::to_string(id) +
+                         "\",\"email\":\"user" + std::to_string(id) + "@example.com\",\"active\":" + (h % 2 ? "true" : "false") +
+                         ",\"score\":" + std::to_string(h % 10000) + ",\"tags\":[";
+    for (int i = 0; i < 4; ++i)
+        record += std::string(i ? "," : "") + "\"tag" + std::to_string((h >> (i * 8)) % 32) + "\"";
+    record += "],\"address\":{\"city\":\"city" + std::to_string(h % 100) + "\",\"street\":\"" + std::to_string(h % 997) +
+              " Main Street\",\"zip\":\"" + std::to_string(10000 + h % 90000) + "\"},\"history\":[";
+    for (int i = 0; i < 16; ++i)
+        record += std::string(i ? "," : "") + "{\"event\":\"" + (((h >> i) & 3) ? "login" : "logout") + "\",\"ts\":" +
+                  std::to_string(1700000000 + (h >> i) % 100000 + i * 60) + ",\"ok\":true}";
+    record += "]}";
+    return record;
+}
+
+// get从底层策略取到条目后在闸门上等待，用来构造get与put交错的时序
+struct GetGate
+{
+    std::atomic<bool> armed{false};
+    std::atomic<bool> reached{false};
+    std::atomic<bool> released{false};
+} getGate;
+
+template <typename Key, typename Value, typename Lock>
+class GatedLruCache : public MyCache::LruCache<Key, Value, Lock>
+{
+public:
+    using MyCache::LruCache<Key, Value, Lock>::LruCache;
+
+    bool get(Key key, Value &value) override
+    {
+        bool found = MyCache::LruCache<Key, Value, Lock>::get(key, value);
+        if (getGate.armed.exchange(false))
+        {
+            getGate.reached = true;
+            while (!getGate.released.load())
+                std::this_thread::yield();
+        }
+        return found;
+    }
+};
+
+void testCompressedCache()
+{
+    std::cout << "\n=== 测试场景14：冷条目透明压缩(CompressedCache) ===" << std::endl;
+
+    const int CAPACITY = 5000;
+    const size_t HOT = 500;
+    const uint64_t KEYS = 20000;
+    const uint64_t OPERATIONS = 200000;
+
+    MyCache::LruCache<uint64_t, std::string> plain(CAPACITY);
+    MyCache::CompressedCache<uint64_t, MyCache::LruCache> builtin(HOT, MyCache::ValueCodec::Kind::Builtin, CAPACITY);
+    MyCache::CompressedCache<uint64_t, MyCache::LruCache> best(HOT, MyCache::ValueCodec::defaultKind(), CAPACITY);
+    std::array<MyCache::CachePolicy<uint64_t, std::string> *, 3> caches = {&plain, &builtin, &best};
+    std::vector<int> hits(3, 0);
+    std::vector<int> get_operations(3, 0);
+    int corrupted = 0;
+
+    MyCache::ZipfGenerator stream(KEYS, 0.9, OPERATIONS, 14);
+    uint64_t key;
+    std::string value;
+    while (stream.next(key))
+    {
+        for (size_t i = 0; i < caches.size(); ++i)
+        {
+            get_operations[i]++;
+            if (caches[i]->get(key, value))
+            {
+                hits[i]++;
+                if (value != makeJsonRecord(key))
+                    corrupted++;
+            }
+            else
+                caches[i]->put(key, makeJsonRecord(key));
+        }
+    }
+
+    printResults("透明压缩", CAPACITY, get_operations, hits,
+                 {"LruCache", "CompressedCache(builtin)", std::string("CompressedCache(") + MyCache::ValueCodec::name(best.codec()) + ")"});
+    for (auto *cache : {&builtin, &best})
+    {
+        std::cout << MyCache::ValueCodec::name(cache->codec()) << ": 原文 " << cache->rawBytes() / 1024 << " KB，实际占用 "
+                  << cache->storedBytes() / 1024 << " KB (" << std::fixed << std::setprecision(2)
+                  << static_cast<double>(cache->rawBytes()) / cache->storedBytes() << "倍)，压缩 " << cache->compressions()
+                  << " 次，解压 " << cache->decompressions() << " 次" << std::endl;
+    }
+    std::cout << "读到与写入不一致的value: " << corrupted << " 次" << std::endl;
+
+    // get取到旧条目后、进热集之前，另一个线程put了新值：新条目被挤出热集后必须已压缩，再读时解压一次；
+    // 热集指向旧条目时，新条目留着hot标记却不在热集里，永远不会被压缩
+    const uint64_t RACE_KEY = 0;
+    const size_t RACE_HOT = 4;
+    MyCache::CompressedCache<uint64_t, GatedLruCache> racy(RACE_HOT, MyCache::ValueCodec::Kind::Builtin, CAPACITY);
+    racy.put(RACE_KEY, makeJsonRecord(1));
+    getGate.armed = true;
+    std::thread reader([&racy]()
+                       {
+        std::string v;
+        racy.get(RACE_KEY, v); });
+    while (!getGate.reached.load())
+        std::this_thread::yield();
+    racy.put(RACE_KEY, makeJsonRecord(2));
+    getGate.released = true;
+    reader.join();
+    for (uint64_t k = 1; k <= RACE_HOT; ++k)
+        racy.put(k, makeJsonRecord(k));
+    uint64_t before = racy.decompressions();
+    bool latest = racy.get(RACE_KEY, value) && value == makeJsonRecord(2);
+    std::cout << "get与put交错后挤出热集: 新条目" << (racy.decompressions() - before == 1 ? "已压缩" : "未压缩")
+              << "，读到最新值: " << (latest ? "是" : "否") << std::endl;
+}
+
+void testTaggedCache()
+{
+    std::cout << "\n=== 测试场景15：按标签批量失效(TaggedCache) ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const uint64_t KEYS = 10000;
+    const uint64_t TENANTS = 50;
+    const uint64_t HOT_KEYS = 64;
+    const int READERS = 4;
+
+    // 每个key带两个标签：所属租户和类型；失效一个租户和一种类型后逐个检查
+    using LfuBackend = MyCache::HashLfuCache<uint64_t, std::shared_ptr<const MyCache::TaggedEntry<uint64_t>>>;
+    MyCache::TaggedCache<uint64_t, uint64_t> lru(std::make_shared<MyCache::HashLruCache<uint64_t, std::shared_ptr<const MyCache::TaggedEntry<uint64_t>>>>(CAPACITY, 4));
+    MyCache::TaggedCache<uint64_t, uint64_t, LfuBackend> lfu(std::make_shared<LfuBackend>(CAPACITY, 4));
+    std::array<MyCache::CachePolicy<uint64_t, uint64_t> *, 2> caches = {&lru, &lfu};
+    std::array<std::string, 2> names = {"HashLruCache", "HashLfuCache"};
+    auto tagsOf = [](uint64_t key)
+    {
+        return std::vector<std::string>{"tenant:" + std::to_string(key % TENANTS), "type:" + std::to_string(key % 3)};
+    };
+    for (uint64_t key = 0; key < KEYS; ++key)
+    {
+        lru.put(key, key, tagsOf(key));
+        lfu.put(key, key, tagsOf(key));
+    }
+    lru.invalidateTag("tenant:7");
+    lfu.invalidateTag("tenant:7");
+    lru.invalidateTag("type:1");
+    lfu.invalidateTag("type:1");
+    lru.invalidateTag("tenant:unknown");
+    for (size_t i = 0; i < caches.size(); ++i)
+    {
+        int wrongHits = 0, wrongMisses = 0;
+        uint64_t value;
+        for (uint64_t key = 0; key < KEYS; ++key)
+        {
+            bool expected = key % TENANTS != 7 && key % 3 != 1;
+            bool hit = caches[i]->get(key, value) && value == key;
+            wrongHits += hit && !expected;
+            wrongMisses += !hit && expected;
+        }
+        std::cout << names[i] << " - 失效后仍命中: " << wrongHits << " 次，误失效: " << wrongMisses << " 次" << std::endl;
+    }
+    // 重新写入的key不受之前失效的影响
+    uint64_t value = 0;
+    lru.put(7, 70, tagsOf(7));
+    std::cout << "失效后重新写入: " << (lru.get(7, value) && value == 70 ? "命中" : "未命中") << std::endl;
+
+    // get读到失效条目之后、判断失效之前，另一个线程写入了新值：新值不能被这次get删掉
+    using GatedBackend = GatedLruCache<uint64_t, std::shared_ptr<const MyCache::TaggedEntry<uint64_t>>, std::mutex>;
+    MyCache::TaggedCache<uint64_t, uint64_t, GatedBackend> gated(std::make_shared<GatedBackend>(CAPACITY));
+    gated.put(1, 10, {"gated"});
+    gated.invalidateTag("gated");
+    getGate.reached = false;
+    getGate.released = false;
+    getGate.armed = true;
+    std::thread staleReader([&gated]()
+                            {
+        uint64_t v;
+        gated.get(1, v); });
+    while (!getGate.reached.load())
+        std::this_thread::yield();
+    gated.put(1, 11);
+    getGate.released = true;
+    staleReader.join();
+    std::cout << "读到失效条目时并发写入新值: " << (gated.get(1, value) && value == 11 ? "新值保留" : "新值丢失") << std::endl;
+
+    // 并发：写线程每轮重写热点key并失效它们的标签，失效返回后公布轮次；
+    // 读线程先读公布的轮次再get，命中的值不能属于已失效的轮次
+    MyCache::TaggedCache<uint64_t, uint64_t> shared(std::make_shared<MyCache::HashLruCache<uint64_t, std::shared_ptr<const MyCache::TaggedEntry<uint64_t>>>>(CAPACITY, 4));
+    std::atomic<uint64_t> invalidated(0);
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> staleReads(0), reads(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < READERS; ++t)
+    {
+        readers.emplace_back([&, t]()
+                             {
+            uint64_t k = t, v;
+            while (!done.load())
+            {
+                k = (k + 1) % HOT_KEYS;
+                uint64_t floor = invalidated.load();
+                if (shared.get(k, v) && v <= floor)
+                    staleReads++;
+                reads++;
+            } });
+    }
+    for (uint64_t round = 1; round <= 2000; ++round)
+    {
+        for (uint64_t k = 0; k < HOT_KEYS; ++k)
+            shared.put(k, round, {"hot"});
+        shared.invalidateTag("hot");
+        invalidated.store(round);
+    }
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+    std::cout << "并发读 " << reads.load() << " 次，读到已失效的值: " << staleReads.load() << " 次，仍被引用的标签: "
+              << shared.tagCount() << std::endl;
+}
+// 边写边遍历：写线程不断读写偶数key(不触发淘汰)，从没被访问的奇数key应恰好返回一次，value都要正确
+template <typename Cache>
+void checkScanUnderWrites(const std::string &name, Cache &cache, uint64_t keys, bool inserting)
+{
+    for (uint64_t key = 0; key < keys; ++key)
+        cache.put(key, key * 7);
+    std::atomic<bool> done(false);
+    std::thread writer([&]()
+                       {
+        std::mt19937_64 rng(5);
+        uint64_t value, fresh = keys;
+        while (!done.load())
+        {
+            uint64_t key = rng() % keys & ~1ULL;
+            if (inserting)
+            {
+                cache.put(fresh, fresh * 7); // 写入新key，会淘汰旧key
+                fresh++;
+            }
+            else if (rng() % 4 == 0)
+                cache.put(key, key * 7);
+            else
+                cache.get(key, value);
+        } });
+    std::vector<int> seen(keys, 0);
+    int chunks = 0, wrongValues = 0;
+    size_t returned = 0;
+    auto scanner = cache.scan();
+    std::vector<std::pair<uint64_t, uint64_t>> chunk;
+    while (scanner.next(chunk, 64))
+    {
+        chunks++;
+        returned += chunk.size();
+        for (const auto &entry : chunk)
+        {
+            wrongValues += entry.second != entry.first * 7;
+            if (entry.first < keys)
+                seen[entry.first]++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50)); // 模拟处理每块的耗时，让写线程穿插进来
+    }
+    done = true;
+    writer.join();
+    int missing = 0, duplicates = 0, touched = 0;
+    for (uint64_t key = 0; key < keys; ++key)
+    {
+        if (key % 2)
+            missing += seen[key] == 0;
+        else
+            touched += seen[key] > 0;
+        duplicates += seen[key] > 1 ? seen[key] - 1 : 0;
+    }
+    std::cout << std::left << std::setw(14) << name << " 分块: " << std::setw(5) << chunks << " 返回: " << std::setw(6) << returned;
+    if (!inserting)
+        std::cout << " 未访问的key漏掉: " << missing << " 重复: " << duplicates << " 被访问的key返回: " << touched << "/" << keys / 2;
+    std::cout << " value错误: " << wrongValues << std::endl;
+}
+
+// 用分块遍历数出缓存中实际的条目数
+template <typename Cache>
+size_t countEntries(Cache &cache)
+{
+    size_t count = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> chunk;
+    auto scanner = cache.scan();
+    while (scanner.next(chunk, 1024))
+        count += chunk.size();
+    return count;
+}
+
+void testSnapshotScan()
+{
+    std::cout << "\n=== 测试场景16：弱一致的分块遍历(Scanner) ===" << std::endl;
+
+    const int CAPACITY = 20000;
+    const uint64_t KEYS = 10000;
+
+    // 按遍历顺序的逆序重新put，得到的最近访问顺序与原缓存一致(热重启导出)
+    MyCache::LruCache<uint64_t, uint64_t> source(CAPACITY);
+    MyCache::ZipfGenerator stream(KEYS, 0.9, 100000, 16);
+    uint64_t key, value;
+    while (stream.next(key))
+    {
+        if (!source.get(key, value))
+            source.put(key, key * 7);
+    }
+    auto collect = [](MyCache::LruCache<uint64_t, uint64_t> &cache)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> all, chunk;
+        auto scanner = cache.scan();
+        while (scanner.next(chunk, 1000))
+            all.insert(all.end(), chunk.begin(), chunk.end());
+        return all;
+    };
+    std::vector<std::pair<uint64_t, uint64_t>> exported = collect(source);
+    MyCache::LruCache<uint64_t, uint64_t> restored(CAPACITY);
+    for (auto it = exported.rbegin(); it != exported.rend(); ++it)
+        restored.put(it->first, it->second);
+    std::cout << "导出 " << exported.size() << " 个条目，逆序重新导入后顺序"
+              << (collect(restored) == exported ? "一致" : "不一致") << std::endl;
+
+    MyCache::LruCache<uint64_t, uint64_t> lru(CAPACITY);
+    MyCache::LfuCache<uint64_t, uint64_t> lfu(CAPACITY);
+    MyCache::ArcCache<uint64_t, uint64_t> arc(CAPACITY);
+    MyCache::HashLruCache<uint64_t, uint64_t> hashLru(CAPACITY, 4);
+    MyCache::HashLfuCache<uint64_t, uint64_t> hashLfu(CAPACITY, 4);
+    checkScanUnderWrites("LruCache", lru, KEYS, false);
+    checkScanUnderWrites("LfuCache", lfu, KEYS, false);
+    checkScanUnderWrites("ArcCache", arc, KEYS, false);
+    checkScanUnderWrites("HashLruCache", hashLru, KEYS, false);
+    checkScanUnderWrites("HashLfuCache", hashLfu, KEYS, false);
+
+    // 遍历期间不断写入新key、淘汰旧key，游标不能被淘汰掉，返回的value也不能错
+    MyCache::HashLruCache<uint64_t, uint64_t> evictingLru(KEYS, 4);
+    MyCache::HashLfuCache<uint64_t, uint64_t> evictingLfu(KEYS, 4);
+    checkScanUnderWrites("EvictingLru", evictingLru, KEYS, true);
+    checkScanUnderWrites("EvictingLfu", evictingLfu, KEYS, true);
+
+    // 遍历到一半时purge：游标不能随节点一起释放，之后的next直接结束，不返回purge之前的key
+    MyCache::LfuCache<uint64_t, uint64_t> purged(CAPACITY);
+    MyCache::HashLfuCache<uint64_t, uint64_t> hashPurged(CAPACITY, 4);
+    for (uint64_t k = 0; k < KEYS; ++k)
+    {
+        purged.put(k, k);
+        hashPurged.put(k, k);
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> chunk;
+    auto scanner = purged.scan();
+    auto second = purged.scan();
+    scanner.next(chunk, 100);
+    purged.purge();
+    for (uint64_t k = KEYS; k < KEYS + 100; ++k)
+        purged.put(k, k);
+    size_t stale = 0, returned = 0;
+    while (scanner.next(chunk, 100))
+    {
+        returned += chunk.size();
+        for (auto &entry : chunk)
+            stale += entry.first < KEYS;
+    }
+    auto hashScanner = hashPurged.scan();
+    hashScanner.next(chunk, 100);
+    hashPurged.purge();
+    hashPurged.put(KEYS, KEYS);
+    while (hashScanner.next(chunk, 100))
+        for (auto &entry : chunk)
+            stale += entry.first < KEYS;
+    std::cout << "遍历期间purge: 之后返回 " << returned << " 个条目，其中purge之前的key " << stale
+              << " 个，purge后条目数 " << countEntries(purged) << std::endl;
+}
+
+// 缩容后看put逐步淘汰的进度，再用evictExcess收尾；扩容后填满不应丢失条目
+template <typename Cache>
+void checkResize(const std::string &name, Cache &cache, uint64_t capacity)
+{
+    uint64_t next = 0;
+    for (; next < capacity; ++next)
+        cache.put(next, next);
+    cache.setCapacity(capacity / 5);
+    size_t afterShrink = countEntries(cache);
+    for (int i = 0; i < 20; ++i, ++next)
+        cache.put(next, next);
+    size_t afterPuts = countEntries(cache);
+    int batches = 0;
+    while (cache.evictExcess(64))
+        batches++;
+    size_t settled = countEntries(cache);
+    cache.setCapacity(capacity * 2);
+    for (uint64_t i = 0; i < capacity * 2; ++i, ++next)
+        cache.put(next, next);
+    size_t grown = countEntries(cache);
+    std::cout << std::left << std::setw(14) << name << " 缩容到" << capacity / 5 << "后: " << std::setw(6) << afterShrink
+              << " 20次put后: " << std::setw(6) << afterPuts << " evictExcess " << std::setw(3) << batches << "批后: " << std::setw(6) << settled
+              << " 扩容到" << capacity * 2 << "并写满: " << grown << std::endl;
+}
+
+void testOnlineResize()
+{
+    std::cout << "\n=== 测试场景17：在线调整容量(setCapacity) ===" << std::endl;
+
+    const uint64_t CAPACITY = 10000;
+
+    MyCache::LruCache<uint64_t, uint64_t> lru(CAPACITY);
+    MyCache::LfuCache<uint64_t, uint64_t> lfu(CAPACITY);
+    MyCache::ArcCache<uint64_t, uint64_t> arc(CAPACITY);
+    MyCache::HashLruCache<uint64_t, uint64_t> hashLru(CAPACITY, 4);
+    MyCache::HashLfuCache<uint64_t, uint64_t> hashLfu(CAPACITY, 4);
+    checkResize("LruCache", lru, CAPACITY);
+    checkResize("LfuCache", lfu, CAPACITY);
+    checkResize("ArcCache", arc, CAPACITY);
+    checkResize("HashLruCache", hashLru, CAPACITY);
+    checkResize("HashLfuCache", hashLfu, CAPACITY);
+
+    // 开启后台维护时缩容由后台分批完成
+    auto executor = std::make_shared<MyCache::MaintenanceExecutor>(1);
+    MyCache::HashLruCache<uint64_t, uint64_t> background(CAPACITY, 4, executor);
+    for (uint64_t key = 0; key < CAPACITY; ++key)
+        background.put(key, key);
+    background.setCapacity(CAPACITY / 5);
+    auto begin = std::chrono::steady_clock::now();
+    while (background.evictExcess(0) && std::chrono::steady_clock::now() - begin < std::chrono::seconds(5))
+        std::this_thread::yield();
+    std::cout << "后台维护: 缩容到" << CAPACITY / 5 << "后剩余 " << countEntries(background) << " 个条目" << std::endl;
+
+    // ArcCache一边调整容量一边被多线程读写：幽灵表命中时两部分互相转移容量，与setCapacity的缩放不能互相覆盖
+    MyCache::ArcCache<uint64_t, uint64_t> resizingArc(64);
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([&resizingArc, &stop, t]()
+                             {
+            std::mt19937_64 gen(t);
+            uint64_t v;
+            while (!stop.load())
+            {
+                uint64_t k = gen() % 512;
+                if (!resizingArc.get(k, v))
+                    resizingArc.put(k, k);
+            } });
+    }
+    for (int round = 0; round < 200; ++round)
+    {
+        resizingArc.setCapacity(round % 2 ? 32 : 128);
+        std::this_thread::yield();
+    }
+    stop = true;
+    for (auto &worker : workers)
+        worker.join();
+    resizingArc.setCapacity(64);
+    while (resizingArc.evictExcess(64))
+        ;
+    std::cout << "ArcCache并发读写中调整容量200次后: 容量 " << resizingArc.getCapacity() << "，条目数 " << countEntries(resizingArc) << std::endl;
+}
 int main()
 {
     testHotDataAccess();
     testLoopPattern();
     testWorkloadShift();
+    testSkewedSlices();
+    testSampledLfu();
+    testMissRatioCurves();
+    testShardsTracker();
+    testCacheEngine();
+    testConcurrentLru();
+    testRefreshAhead();
+    testScanResistance();
+    testSizeAwareEviction();
+    testNearCache();
+    testCompressedCache();
+    testTaggedCache();
+    testSnapshotScan();
+    testOnlineResize();
 
     return 0;
 }
\ No newline at end of file
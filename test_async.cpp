@@ -0,0 +1,159 @@
+#include "AsyncCache.hpp"
+#include "LruCache.hpp"
+#include "LfuCache.hpp"
+#include "ArcCache/ArcCache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 最简单的即发即弃协程，只用于测试
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// 手动驱动的加载器：记录加载请求，由测试决定何时完成
+struct ManualLoader
+{
+    int calls = 0;
+    std::vector<std::pair<int, MyCache::AsyncCache<int, std::string>::Completion>> pending;
+
+    MyCache::AsyncCache<int, std::string>::Loader loader()
+    {
+        return [this](const int &key, MyCache::AsyncCache<int, std::string>::Completion done)
+        {
+            calls++;
+            pending.emplace_back(key, std::move(done));
+        };
+    }
+
+    void completeAll()
+    {
+        auto requests = std::move(pending);
+        pending.clear();
+        for (auto &request : requests)
+            request.second(request.first < 0 ? std::nullopt : std::optional<std::string>("value" + std::to_string(request.first)));
+    }
+};
+
+DetachedTask fetch(MyCache::AsyncCache<int, std::string> &cache, int key,
+                   MyCache::AsyncCache<int, std::string>::Loader loader, std::vector<std::string> &results)
+{
+    std::optional<std::string> value = co_await cache.getAsync(key, std::move(loader));
+    results.push_back(value ? *value : "<加载失败>");
+}
+
+void testSharedLoads(const std::string &name, MyCache::CachePolicy<int, std::string> &policy)
+{
+    std::deque<std::coroutine_handle<>> ready;
+    MyCache::AsyncCache<int, std::string> cache(policy, [&](std::coroutine_handle<> handle)
+                                                { ready.push_back(handle); });
+    ManualLoader loader;
+    std::vector<std::string> results;
+
+    // 10个协程同时等待同一个key，只触发一次加载
+    for (int i = 0; i < 10; ++i)
+        fetch(cache, 1, loader.loader(), results);
+    fetch(cache, -1, loader.loader(), results); // 加载失败
+    size_t suspended = results.size();
+    loader.completeAll();
+    size_t beforeResume = results.size();
+    while (!ready.empty())
+    {
+        ready.front().resume();
+        ready.pop_front();
+    }
+
+    // 命中在await_ready中同步完成，不经过执行器
+    fetch(cache, 1, loader.loader(), results);
+    bool hitSynchronous = ready.empty() && results.size() == 12;
+
+    std::cout << name << " - 加载次数: " << loader.calls
+              << "，挂起期间完成数: " << suspended
+              << "，执行器恢复前完成数: " << beforeResume
+              << "，完成数: " << results.size()
+              << "，首个结果: " << results.front()
+              << "，失败结果: " << (results.size() > 10 ? results[10] : "")
+              << "，命中同步完成: " << (hitSynchronous ? "是" : "否") << std::endl;
+}
+
+void testConcurrentWaiters()
+{
+    const int THREADS = 4;
+    const int COROUTINES_PER_THREAD = 2000;
+    const int KEYS = 50;
+
+    MyCache::LruCache<int, std::string> lru(KEYS);
+    MyCache::AsyncCache<int, std::string> cache(lru);
+    std::atomic<int> loads(0);
+    std::atomic<int> completed(0);
+    std::vector<std::thread> loaderThreads;
+    std::mutex loaderMutex;
+
+    // 加载在独立线程上延迟完成，恢复也发生在该线程
+    auto loader = [&](const int &key, MyCache::AsyncCache<int, std::string>::Completion done)
+    {
+        loads++;
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loaderThreads.emplace_back([key, done]()
+                                   {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            done("value" + std::to_string(key)); });
+    };
+
+    auto fetchOne = [&](int key) -> DetachedTask
+    {
+        std::optional<std::string> value = co_await cache.getAsync(key, loader);
+        if (value && *value == "value" + std::to_string(key))
+            completed++;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < COROUTINES_PER_THREAD; ++i)
+                fetchOne((t * COROUTINES_PER_THREAD + i) % KEYS); });
+    }
+    for (auto &worker : workers)
+        worker.join();
+    while (completed.load() < THREADS * COROUTINES_PER_THREAD)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        for (auto &thread : loaderThreads)
+            thread.join();
+    }
+
+    std::cout << "多线程等待 - 协程数: " << THREADS * COROUTINES_PER_THREAD
+              << "，正确完成: " << completed.load()
+              << "，加载次数: " << loads.load() << " (key数: " << KEYS << ")" << std::endl;
+}
+
+int main()
+{
+    std::cout << "=== 异步测试：共享加载与协程恢复 ===" << std::endl;
+    MyCache::LruCache<int, std::string> lru(100);
+    MyCache::LfuCache<int, std::string> lfu(100);
+    MyCache::ArcCache<int, std::string> arc(100);
+    testSharedLoads("LRU", lru);
+    testSharedLoads("LFU", lfu);
+    testSharedLoads("ARC", arc);
+    testConcurrentWaiters();
+    return 0;
+}